@@ -15,14 +15,12 @@ namespace AlgorithmAccumulate {
                 vec.begin(),
                 vec.end(),
                 std::string{}, // first element
-                [counter = 0](const std::string& first, const auto& next) mutable {
+                [counter = 0](std::string first, const auto& next) mutable {
+                    // accumulator is taken by value: std::accumulate moves it in,
+                    // so appending to it keeps the whole fold linear
                     counter++;
-                    std::ostringstream ss;
-                    ss << std::setfill('0') << std::setw(2) << counter
-                        << ": " << std::setfill(' ') << std::setw(10)
-                        << std::right << next << std::endl;
-
-                    return first + ss.str();
+                    std::format_to(std::back_inserter(first), "{:02}: {:>10}\n", counter, next);
+                    return first;
                 }
             ) 
         };
@@ -38,14 +36,12 @@ namespace AlgorithmAccumulate {
                 vec.begin(),
                 vec.end(),
                 std::string{}, // first element
-                [counter = 0](const std::string& first, const T& next) mutable {
+                [counter = 0](std::string first, const T& next) mutable {
+                    // accumulator is taken by value: std::accumulate moves it in,
+                    // so appending to it keeps the whole fold linear
                     counter++;
-                    std::ostringstream ss;
-                    ss << std::setfill('0') << std::setw(2) << counter
-                        << ": " << std::setfill(' ') << std::setw(10)
-                        << std::right << next << std::endl;
-
-                    return first + ss.str();
+                    std::format_to(std::back_inserter(first), "{:02}: {:>10}\n", counter, next);
+                    return first;
                 }
             ) 
         };
@@ -0,0 +1,262 @@
+// =====================================================================================
+// Accumulate_StringBuilder.cpp // Building large strings in linear time
+// =====================================================================================
+
+module modern_cpp:accumulate;
+
+import std;
+import scoped_timer;
+
+namespace AlgorithmAccumulateStringBuilder {
+
+    // =================================================================================
+    // Global constants
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::array<std::size_t, 3> Sizes{ 1'000, 10'000, 100'000 };   // debug
+    static constexpr std::size_t MaxSizeQuadratic = 1'000;                        // debug
+#else
+    static constexpr std::array<std::size_t, 3> Sizes{ 10'000, 100'000, 1'000'000 };  // release
+    static constexpr std::size_t MaxSizeQuadratic = 10'000;                          // release
+#endif
+
+    // =================================================================================
+    // class StringBuilder: one appendable buffer, growing geometrically
+    // =================================================================================
+
+    class StringBuilder
+    {
+    private:
+        std::string m_buffer;
+
+    public:
+        StringBuilder() = default;
+
+        explicit StringBuilder(std::size_t capacity) {
+            m_buffer.reserve(capacity);
+        }
+
+        void reserve(std::size_t capacity) { m_buffer.reserve(capacity); }
+        void clear() noexcept { m_buffer.clear(); }
+
+        std::size_t size() const noexcept { return m_buffer.size(); }
+        std::size_t capacity() const noexcept { return m_buffer.capacity(); }
+
+        StringBuilder& append(std::string_view sv) {
+            m_buffer.append(sv);
+            return *this;
+        }
+
+        StringBuilder& append(char ch) {
+            m_buffer.push_back(ch);
+            return *this;
+        }
+
+        // formats directly into the buffer - no temporary std::string is created
+        template <typename... TArgs>
+        StringBuilder& appendFormat(std::format_string<TArgs...> fmt, TArgs&&... args) {
+            std::format_to(std::back_inserter(m_buffer), fmt, std::forward<TArgs>(args)...);
+            return *this;
+        }
+
+        std::string_view view() const noexcept { return m_buffer; }
+
+        // moves the buffer out, the builder is empty afterwards
+        std::string str() && { return std::move(m_buffer); }
+        std::string str() const& { return m_buffer; }
+    };
+
+    // =================================================================================
+    // line format used by all toString variants ("01:       Hans")
+    // =================================================================================
+
+    static constexpr std::string_view LineFormat{ "{:02}: {:>10}\n" };
+
+    // =================================================================================
+    // classic version (see Accumulate.cpp): the accumulator is copied in every step,
+    // which results in O(n^2) copied bytes and two allocations per element
+    // =================================================================================
+
+    template <typename T>
+    static std::string toStringQuadratic(const std::vector<T>& vec) {
+
+        return std::accumulate(
+            vec.begin(),
+            vec.end(),
+            std::string{},
+            [counter = 0](const std::string& first, const T& next) mutable {
+                counter++;
+                std::ostringstream ss;
+                ss << std::setfill('0') << std::setw(2) << counter
+                    << ": " << std::setfill(' ') << std::setw(10)
+                    << std::right << next << std::endl;
+
+                return first + ss.str();
+            }
+        );
+    }
+
+    // =================================================================================
+    // fold variant: the accumulator is moved from step to step (std::accumulate
+    // does so since C++20), each step only appends to the very same buffer
+    // =================================================================================
+
+    template <typename InputIt, typename T, typename TBinaryOp>
+    static T foldLeftMove(InputIt first, InputIt last, T init, TBinaryOp op)
+    {
+        for (; first != last; ++first) {
+            init = op(std::move(init), *first);
+        }
+        return init;
+    }
+
+    template <typename T>
+    static std::string toStringFold(const std::vector<T>& vec) {
+
+        return foldLeftMove(
+            vec.begin(),
+            vec.end(),
+            std::string{},
+            [counter = 0](std::string first, const T& next) mutable {
+                counter++;
+                std::format_to(std::back_inserter(first), LineFormat, counter, next);
+                return first;
+            }
+        );
+    }
+
+    // =================================================================================
+    // StringBuilder variant: formats into a single growing buffer
+    // =================================================================================
+
+    template <typename T>
+    static std::string toStringBuilder(const std::vector<T>& vec) {
+
+        StringBuilder builder{};
+
+        std::size_t counter{};
+        for (const auto& elem : vec) {
+            ++counter;
+            builder.appendFormat(LineFormat, counter, elem);
+        }
+
+        return std::move(builder).str();
+    }
+
+    // =================================================================================
+    // pre-sized variant: a first pass computes the exact length of the result,
+    // the second pass formats without any reallocation
+    // =================================================================================
+
+    template <typename T>
+    static std::string toStringPresized(const std::vector<T>& vec) {
+
+        std::size_t length{};
+        std::size_t counter{};
+        for (const auto& elem : vec) {
+            ++counter;
+            length += std::formatted_size(LineFormat, counter, elem);
+        }
+
+        StringBuilder builder{ length };
+
+        counter = 0;
+        for (const auto& elem : vec) {
+            ++counter;
+            builder.appendFormat(LineFormat, counter, elem);
+        }
+
+        return std::move(builder).str();
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01() {
+
+        std::vector<std::string> names{ "Hans", "Sepp", "Georg" };
+
+        std::println("{}", toStringQuadratic(names));
+        std::println("{}", toStringFold(names));
+        std::println("{}", toStringBuilder(names));
+        std::println("{}", toStringPresized(names));
+    }
+
+    static void test_02() {
+
+        std::vector<float> digits{ 10.5f, 11.5f, 12.5f, 13.5f, 14.5f, 15.5f };
+
+        std::string s1{ toStringQuadratic(digits) };
+        std::string s2{ toStringFold(digits) };
+        std::string s3{ toStringBuilder(digits) };
+        std::string s4{ toStringPresized(digits) };
+
+        std::println("{}", s4);
+        std::println("All results equal: {}", s1 == s2 && s2 == s3 && s3 == s4);
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+    static std::vector<std::string> createNames(std::size_t count) {
+
+        static constexpr std::array<std::string_view, 5> Names{
+            "Hans", "Sepp", "Georg", "Anton", "Maximilian"
+        };
+
+        std::vector<std::string> names;
+        names.reserve(count);
+
+        for (std::size_t i{}; i != count; ++i) {
+            names.emplace_back(Names[i % Names.size()]);
+        }
+
+        return names;
+    }
+
+    template <typename TFunc>
+    static void benchmark(std::string_view label, const std::vector<std::string>& names, TFunc func) {
+
+        std::println("{:<28} {:>9} elements", label, names.size());
+
+        std::size_t length{};
+        {
+            ScopedTimer watch{};
+            length = func(names).size();
+        }
+
+        std::println("Length of result: {}", length);
+    }
+
+    static void test_03() {
+
+        for (auto size : Sizes) {
+
+            std::vector<std::string> names{ createNames(size) };
+
+            if (size <= MaxSizeQuadratic) {
+                benchmark("std::accumulate (copying):", names, toStringQuadratic<std::string>);
+            }
+
+            benchmark("foldLeftMove:", names, toStringFold<std::string>);
+            benchmark("StringBuilder:", names, toStringBuilder<std::string>);
+            benchmark("StringBuilder (pre-sized):", names, toStringPresized<std::string>);
+            std::println();
+        }
+    }
+}
+
+void main_accumulate_string_builder()
+{
+    using namespace AlgorithmAccumulateStringBuilder;
+    test_01();
+    test_02();
+    test_03();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
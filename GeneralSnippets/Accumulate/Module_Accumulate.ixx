@@ -5,6 +5,7 @@
 export module modern_cpp:accumulate;
 
 export void main_accumulate();
+export void main_accumulate_string_builder();
 
 // =====================================================================================
 // End-of-File
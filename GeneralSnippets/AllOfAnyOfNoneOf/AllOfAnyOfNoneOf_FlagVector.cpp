@@ -0,0 +1,457 @@
+// =====================================================================================
+// AllOfAnyOfNoneOf_FlagVector.cpp // all / any / none / count on bit-packed flags
+// =====================================================================================
+
+module modern_cpp:all_of_any_of_none_of;
+
+import std;
+import scoped_timer;
+
+namespace AllOfAnyOfNoneOfFlagVector {
+
+    // =================================================================================
+    // FlagVector: dynamic sequence of flags, 64 flags per machine word
+    //
+    // all(), any(), none() process blocks of 8 words (512 flags) with a
+    // branch-free AND / OR reduction - compilers map a block onto a few SIMD
+    // instructions - and stop at the first block deciding the result.
+    // count() uses std::popcount on whole words.
+    // Overloads with an execution policy split very large vectors into chunks,
+    // a chunk finding the result stops all other chunks. The sequential scan is
+    // already bounded by memory bandwidth - the parallel versions pay off only
+    // on machines with several memory channels.
+    //
+    // Invariant: unused bits of the last word are always 0.
+    // =================================================================================
+
+    class FlagVector
+    {
+    private:
+        static constexpr std::size_t BitsPerWord{ 64 };
+        static constexpr std::size_t BlockWords{ 8 };               // 512 flags
+        static constexpr std::size_t ChunkWords{ 64 * 1024 };       // parallel mode
+        static constexpr std::uint64_t AllOnes{ ~std::uint64_t{} };
+
+        std::vector<std::uint64_t> m_words;
+        std::size_t                m_size;
+
+    public:
+        FlagVector() : m_words{}, m_size{} {}
+
+        explicit FlagVector(std::size_t size, bool value = false)
+            : m_words((size + BitsPerWord - 1) / BitsPerWord, value ? AllOnes : 0), m_size{ size }
+        {
+            clearUnusedBits();
+        }
+
+        FlagVector(std::initializer_list<bool> flags) : FlagVector{}
+        {
+            m_words.reserve((flags.size() + BitsPerWord - 1) / BitsPerWord);
+            for (bool flag : flags) {
+                push_back(flag);
+            }
+        }
+
+        std::size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+
+        bool test(std::size_t index) const noexcept {
+            return (m_words[index / BitsPerWord] >> (index % BitsPerWord)) & 1;
+        }
+
+        bool operator[] (std::size_t index) const noexcept { return test(index); }
+
+        void set(std::size_t index, bool value = true) noexcept
+        {
+            const std::uint64_t mask{ std::uint64_t{ 1 } << (index % BitsPerWord) };
+            if (value) {
+                m_words[index / BitsPerWord] |= mask;
+            }
+            else {
+                m_words[index / BitsPerWord] &= ~mask;
+            }
+        }
+
+        void push_back(bool value)
+        {
+            if (m_size % BitsPerWord == 0) {
+                m_words.push_back(0);
+            }
+            ++m_size;
+            set(m_size - 1, value);
+        }
+
+        std::span<const std::uint64_t> words() const noexcept { return m_words; }
+
+        // =============================================================================
+        // reductions
+        // =============================================================================
+
+        bool all() const noexcept
+        {
+            const std::size_t fullWords{ m_size / BitsPerWord };
+
+            if (!allOnes(0, fullWords, nullptr)) {
+                return false;
+            }
+
+            // last, partially used word
+            return m_size % BitsPerWord == 0 || m_words[fullWords] == tailMask();
+        }
+
+        bool any() const noexcept
+        {
+            return anySet(0, m_words.size(), nullptr);
+        }
+
+        bool none() const noexcept
+        {
+            return !any();
+        }
+
+        std::size_t count() const noexcept
+        {
+            return countRange(0, m_words.size());
+        }
+
+        // parallel versions
+        template <typename TPolicy>
+            requires std::is_execution_policy_v<std::remove_cvref_t<TPolicy>>
+        bool all(TPolicy&& policy) const
+        {
+            const std::size_t fullWords{ m_size / BitsPerWord };
+
+            if (!forEachChunk(std::forward<TPolicy>(policy), fullWords,
+                [this](std::size_t first, std::size_t last, const std::atomic<bool>* stop) {
+                    return !allOnes(first, last, stop);
+                }))
+            {
+                return m_size % BitsPerWord == 0 || m_words[fullWords] == tailMask();
+            }
+
+            return false;
+        }
+
+        template <typename TPolicy>
+            requires std::is_execution_policy_v<std::remove_cvref_t<TPolicy>>
+        bool any(TPolicy&& policy) const
+        {
+            return forEachChunk(std::forward<TPolicy>(policy), m_words.size(),
+                [this](std::size_t first, std::size_t last, const std::atomic<bool>* stop) {
+                    return anySet(first, last, stop);
+                });
+        }
+
+        template <typename TPolicy>
+            requires std::is_execution_policy_v<std::remove_cvref_t<TPolicy>>
+        bool none(TPolicy&& policy) const
+        {
+            return !any(std::forward<TPolicy>(policy));
+        }
+
+        template <typename TPolicy>
+            requires std::is_execution_policy_v<std::remove_cvref_t<TPolicy>>
+        std::size_t count(TPolicy&& policy) const
+        {
+            return std::transform_reduce(
+                std::forward<TPolicy>(policy),
+                m_words.begin(),
+                m_words.end(),
+                std::size_t{},
+                std::plus<>{},
+                [](std::uint64_t word) { return static_cast<std::size_t>(std::popcount(word)); }
+            );
+        }
+
+    private:
+        std::uint64_t tailMask() const noexcept {
+            return (std::uint64_t{ 1 } << (m_size % BitsPerWord)) - 1;
+        }
+
+        void clearUnusedBits() noexcept {
+            if (m_size % BitsPerWord != 0) {
+                m_words.back() &= tailMask();
+            }
+        }
+
+        // true, if all words in [first, last) are ~0 -
+        // 'stop' (parallel mode) is checked once per block
+        bool allOnes(std::size_t first, std::size_t last, const std::atomic<bool>* stop) const noexcept
+        {
+            const std::uint64_t* words{ m_words.data() };
+
+            std::size_t i{ first };
+            for (; i + BlockWords <= last; i += BlockWords) {
+                std::uint64_t acc{ AllOnes };
+                for (std::size_t k{}; k != BlockWords; ++k) {
+                    acc &= words[i + k];
+                }
+                if (acc != AllOnes || (stop != nullptr && stop->load(std::memory_order_relaxed))) {
+                    return acc == AllOnes;   // a stopped chunk doesn't decide anything
+                }
+            }
+
+            for (; i < last; ++i) {
+                if (words[i] != AllOnes) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool anySet(std::size_t first, std::size_t last, const std::atomic<bool>* stop) const noexcept
+        {
+            const std::uint64_t* words{ m_words.data() };
+
+            std::size_t i{ first };
+            for (; i + BlockWords <= last; i += BlockWords) {
+                std::uint64_t acc{};
+                for (std::size_t k{}; k != BlockWords; ++k) {
+                    acc |= words[i + k];
+                }
+                if (acc != 0 || (stop != nullptr && stop->load(std::memory_order_relaxed))) {
+                    return acc != 0;
+                }
+            }
+
+            for (; i < last; ++i) {
+                if (words[i] != 0) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::size_t countRange(std::size_t first, std::size_t last) const noexcept
+        {
+            const std::uint64_t* words{ m_words.data() };
+
+            // independent partial sums
+            std::array<std::size_t, 4> partial{};
+
+            const std::size_t blocksEnd{ first + (last - first) / 4 * 4 };
+
+            std::size_t i{ first };
+            for (; i != blocksEnd; i += 4) {
+                for (std::size_t k{}; k != 4; ++k) {
+                    partial[k] += static_cast<std::size_t>(std::popcount(words[i + k]));
+                }
+            }
+
+            for (; i < last; ++i) {
+                partial[0] += static_cast<std::size_t>(std::popcount(words[i]));
+            }
+
+            return partial[0] + partial[1] + partial[2] + partial[3];
+        }
+
+        // runs 'decides(first, last, stop)' for all chunks of [0, numWords),
+        // returns true as soon as one chunk decides the result
+        template <typename TPolicy, typename TDecides>
+        static bool forEachChunk(TPolicy&& policy, std::size_t numWords, TDecides decides)
+        {
+            const std::size_t numChunks{ (numWords + ChunkWords - 1) / ChunkWords };
+
+            std::vector<std::size_t> chunks(numChunks);
+            std::iota(chunks.begin(), chunks.end(), std::size_t{});
+
+            std::atomic<bool> decided{ false };
+
+            std::for_each(
+                std::forward<TPolicy>(policy),
+                chunks.begin(),
+                chunks.end(),
+                [&](std::size_t chunk) {
+                    if (decided.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+
+                    const std::size_t first{ chunk * ChunkWords };
+                    const std::size_t last{ std::min(numWords, first + ChunkWords) };
+
+                    if (decides(first, last, &decided)) {
+                        decided.store(true, std::memory_order_relaxed);
+                    }
+                }
+            );
+
+            return decided.load();
+        }
+    };
+
+    // =================================================================================
+    // andAll / orAll (as in Exercises_03_STL.cpp, Exercise 4)
+    // =================================================================================
+
+    template <typename TContainer>
+    static bool andAll(const TContainer& flags) {
+
+        return std::accumulate(
+            std::begin(flags),
+            std::end(flags),
+            true, // starting value
+            [](bool first, bool next) {
+                return first and next;
+            }
+        );
+    }
+
+    template <typename TContainer>
+    static bool orAll(const TContainer& flags) {
+
+        return std::accumulate(
+            std::begin(flags),
+            std::end(flags),
+            false, // starting value
+            [](bool first, bool next) {
+                return first or next;
+            }
+        );
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        FlagVector flags{ true, false, true };
+        std::println("all: {} - any: {} - none: {} - count: {}", flags.all(), flags.any(), flags.none(), flags.count());
+
+        flags = FlagVector{ true, true, true, true, true, true, true, true, true, true };
+        std::println("all: {} - any: {} - none: {} - count: {}", flags.all(), flags.any(), flags.none(), flags.count());
+
+        flags = FlagVector{ false, false, false, false, false, false, false, false, false, false };
+        std::println("all: {} - any: {} - none: {} - count: {}", flags.all(), flags.any(), flags.none(), flags.count());
+
+        // sizes not being a multiple of 64
+        FlagVector many(1000, true);
+        std::println("all: {} - count: {}", many.all(), many.count());
+        many.set(999, false);
+        std::println("all: {} - count: {}", many.all(), many.count());
+        std::println("all (parallel): {} - any (parallel): {}", many.all(std::execution::par), many.any(std::execution::par));
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumFlags = 10'000'000;       // debug
+#else
+    static constexpr std::size_t NumFlags = 500'000'000;      // release
+#endif
+
+    static void benchmarkAll(std::string_view scenario, std::size_t falseAt)
+    {
+        std::println("{}:", scenario);
+
+        std::vector<bool> bools(NumFlags, true);
+        FlagVector flags(NumFlags, true);
+
+        if (falseAt < NumFlags) {
+            bools[falseAt] = false;
+            flags.set(falseAt, false);
+        }
+
+        bool result{};
+
+        std::print("  andAll (std::accumulate):        ");
+        {
+            ScopedTimer watch{};
+            result = andAll(bools);
+        }
+        std::println("  Result: {}", result);
+
+        std::print("  std::all_of (std::vector<bool>): ");
+        {
+            ScopedTimer watch{};
+            result = std::all_of(bools.begin(), bools.end(), [](bool flag) { return flag; });
+        }
+        std::println("  Result: {}", result);
+
+        std::print("  FlagVector::all:                 ");
+        {
+            ScopedTimer watch{};
+            result = flags.all();
+        }
+        std::println("  Result: {}", result);
+
+        std::print("  FlagVector::all (parallel):      ");
+        {
+            ScopedTimer watch{};
+            result = flags.all(std::execution::par);
+        }
+        std::println("  Result: {}", result);
+    }
+
+    static void test_02()
+    {
+        benchmarkAll("All flags set - no early exit", NumFlags);
+        benchmarkAll("One flag cleared in the middle", NumFlags / 2);
+    }
+
+    static void test_03()
+    {
+        std::vector<bool> bools(NumFlags);
+        FlagVector flags(NumFlags);
+
+        std::mt19937_64 engine{ 1 };
+        for (std::size_t i{}; i < NumFlags; i += 1 + engine() % 16) {
+            bools[i] = true;
+            flags.set(i);
+        }
+
+        std::size_t count{};
+
+        std::print("std::count (std::vector<bool>): ");
+        {
+            ScopedTimer watch{};
+            count = static_cast<std::size_t>(std::count(bools.begin(), bools.end(), true));
+        }
+        std::println("  Count: {}", count);
+
+        std::print("FlagVector::count:              ");
+        {
+            ScopedTimer watch{};
+            count = flags.count();
+        }
+        std::println("  Count: {}", count);
+
+        std::print("FlagVector::count (parallel):   ");
+        {
+            ScopedTimer watch{};
+            count = flags.count(std::execution::par);
+        }
+        std::println("  Count: {}", count);
+
+        bool result{};
+        std::print("orAll (std::accumulate):        ");
+        {
+            ScopedTimer watch{};
+            result = orAll(bools);
+        }
+        std::println("  Result: {}", result);
+
+        std::print("FlagVector::any:                ");
+        {
+            ScopedTimer watch{};
+            result = flags.any();
+        }
+        std::println("  Result: {}", result);
+    }
+}
+
+void main_all_of_any_of_none_of_flag_vector()
+{
+    using namespace AllOfAnyOfNoneOfFlagVector;
+    test_01();
+    test_02();
+    test_03();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,7 @@
 export module modern_cpp:all_of_any_of_none_of;
 
 export void main_all_of_any_of_none_of();
+export void main_all_of_any_of_none_of_flag_vector();
 
 // =====================================================================================
 // End-of-File
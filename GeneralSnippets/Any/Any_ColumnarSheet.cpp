@@ -0,0 +1,603 @@
+// =====================================================================================
+// Any_ColumnarSheet.cpp // Spreadsheet with typed columns instead of std::any cells
+// =====================================================================================
+
+module modern_cpp:any;
+
+import std;
+import scoped_timer;
+
+namespace AnyColumnarSheet {
+
+    // =================================================================================
+    // test_03_any in Any.cpp stores a sheet as std::vector<std::tuple<std::any, ...>>:
+    // - every cell knows its type, toString compares type() per cell
+    // - a std::any holding a std::string (or any other larger value) allocates
+    //
+    // Sheet stores its cells per column: the type is a property of the column,
+    // the values are held in one typed vector, strings in one character arena.
+    // Missing values are marked in a bitmap. Operations dispatch once per column
+    // (or once per block of rows), not once per cell.
+    // =================================================================================
+
+    enum class ColumnType { Int64, Double, Bool, String };
+
+    static constexpr std::string_view toString(ColumnType type)
+    {
+        switch (type)
+        {
+        case ColumnType::Int64:  return "int64";
+        case ColumnType::Double: return "double";
+        case ColumnType::Bool:   return "bool";
+        default:                 return "string";
+        }
+    }
+
+    // one bit per cell, set: value present
+    class NullBitmap
+    {
+    private:
+        std::vector<std::uint64_t> m_words;
+        std::size_t                m_size{};
+
+    public:
+        void push_back(bool valid)
+        {
+            if (m_size % 64 == 0) {
+                m_words.push_back(0);
+            }
+
+            m_words.back() |= static_cast<std::uint64_t>(valid) << (m_size % 64);
+            ++m_size;
+        }
+
+        bool isValid(std::size_t index) const noexcept {
+            return (m_words[index / 64] >> (index % 64)) & 1;
+        }
+
+        bool isNull(std::size_t index) const noexcept { return !isValid(index); }
+
+        std::size_t nullCount() const noexcept
+        {
+            std::size_t valid{};
+            for (auto word : m_words) {
+                valid += static_cast<std::size_t>(std::popcount(word));
+            }
+            return m_size - valid;
+        }
+
+        void reserve(std::size_t count) { m_words.reserve((count + 63) / 64); }
+    };
+
+    // all strings of a column in one buffer, addressed by end offsets
+    class StringArena
+    {
+    private:
+        std::string                m_chars;
+        std::vector<std::uint64_t> m_ends;
+
+    public:
+        void push_back(std::string_view value)
+        {
+            m_chars.append(value);
+            m_ends.push_back(m_chars.size());
+        }
+
+        std::string_view operator[](std::size_t index) const noexcept
+        {
+            const std::size_t begin{ index == 0 ? 0 : static_cast<std::size_t>(m_ends[index - 1]) };
+            return { m_chars.data() + begin, static_cast<std::size_t>(m_ends[index]) - begin };
+        }
+
+        std::size_t size() const noexcept { return m_ends.size(); }
+
+        void reserve(std::size_t count, std::size_t chars) {
+            m_ends.reserve(count);
+            m_chars.reserve(chars);
+        }
+    };
+
+    // =================================================================================
+    // Column
+    // =================================================================================
+
+    // appending a value to a column
+    template <typename T>
+    concept CellValue =
+        std::integral<T> || std::floating_point<T> || std::convertible_to<const T&, std::string_view>;
+
+    // column type matching a value, std::nullopt matches every column
+    template <typename T>
+    constexpr bool matches(ColumnType type)
+    {
+        if constexpr (std::is_same_v<T, std::nullopt_t>) {
+            return true;
+        }
+        else if constexpr (requires { typename T::value_type; requires std::is_same_v<T, std::optional<typename T::value_type>>; }) {
+            return matches<typename T::value_type>(type);
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            return type == ColumnType::Bool;
+        }
+        else if constexpr (std::integral<T>) {
+            return type == ColumnType::Int64;
+        }
+        else if constexpr (std::floating_point<T>) {
+            return type == ColumnType::Double;
+        }
+        else {
+            return type == ColumnType::String;
+        }
+    }
+
+    class Column
+    {
+    private:
+        using Values = std::variant<std::vector<std::int64_t>, std::vector<double>, std::vector<bool>, StringArena>;
+
+        std::string m_name;
+        ColumnType  m_type;
+        Values      m_values;
+        NullBitmap  m_valid;
+        std::size_t m_size{};
+
+    public:
+        Column(std::string_view name, ColumnType type)
+            : m_name{ name }, m_type{ type }, m_values{ makeValues(type) }
+        {}
+
+        std::string_view name() const noexcept { return m_name; }
+        ColumnType type() const noexcept { return m_type; }
+        std::size_t size() const noexcept { return m_size; }
+        std::size_t nullCount() const noexcept { return m_valid.nullCount(); }
+        bool isNull(std::size_t row) const noexcept { return m_valid.isNull(row); }
+
+        void reserve(std::size_t count)
+        {
+            m_valid.reserve(count);
+            std::visit([=](auto& values) {
+                if constexpr (std::is_same_v<std::remove_cvref_t<decltype(values)>, StringArena>) {
+                    values.reserve(count, count * 16);
+                }
+                else {
+                    values.reserve(count);
+                }
+            }, m_values);
+        }
+
+        // throws std::invalid_argument, if the value does not match the column type
+        template <typename T>
+            requires CellValue<T>
+        void append(const T& value)
+        {
+            if constexpr (std::is_same_v<T, bool>) {
+                typedValues<std::vector<bool>>().push_back(value);
+            }
+            else if constexpr (std::integral<T>) {
+                typedValues<std::vector<std::int64_t>>().push_back(static_cast<std::int64_t>(value));
+            }
+            else if constexpr (std::floating_point<T>) {
+                typedValues<std::vector<double>>().push_back(static_cast<double>(value));
+            }
+            else {
+                typedValues<StringArena>().push_back(std::string_view{ value });
+            }
+
+            m_valid.push_back(true);
+            ++m_size;
+        }
+
+        template <typename T>
+        void append(const std::optional<T>& value)
+        {
+            if (value.has_value()) {
+                append(*value);
+            }
+            else {
+                appendNull();
+            }
+        }
+
+        void appendNull()
+        {
+            std::visit([](auto& values) { values.push_back({}); }, m_values);
+
+            m_valid.push_back(false);
+            ++m_size;
+        }
+
+        // typed access to all values of the column - null cells hold a default value
+        std::span<const std::int64_t> int64Values() const { return std::get<std::vector<std::int64_t>>(m_values); }
+        std::span<const double> doubleValues() const { return std::get<std::vector<double>>(m_values); }
+        const std::vector<bool>& boolValues() const { return std::get<std::vector<bool>>(m_values); }
+        const StringArena& stringValues() const { return std::get<StringArena>(m_values); }
+
+        // a single cell - slow path, dispatches per call
+        std::string toString(std::size_t row) const
+        {
+            std::string result{};
+            if (!isNull(row)) {
+                std::visit([&](const auto& values) { appendCell(result, values[row]); }, m_values);
+            }
+            return result;
+        }
+
+        // bulk path: formats the rows [first, first + count) one after the other
+        // into 'buffer', the end offset of each cell is stored in 'ends'
+        void formatBlock(std::size_t first, std::size_t count, std::string& buffer, std::vector<std::size_t>& ends) const
+        {
+            std::visit([&](const auto& values) {
+                for (std::size_t row{ first }; row != first + count; ++row) {
+                    if (m_valid.isValid(row)) {
+                        appendCell(buffer, values[row]);
+                    }
+                    ends.push_back(buffer.size());
+                }
+            }, m_values);
+        }
+
+    private:
+        static Values makeValues(ColumnType type)
+        {
+            switch (type)
+            {
+            case ColumnType::Int64:  return std::vector<std::int64_t>{};
+            case ColumnType::Double: return std::vector<double>{};
+            case ColumnType::Bool:   return std::vector<bool>{};
+            default:                 return StringArena{};
+            }
+        }
+
+        template <typename TVector>
+        TVector& typedValues()
+        {
+            auto* values{ std::get_if<TVector>(&m_values) };
+            if (values == nullptr) {
+                throw std::invalid_argument{ std::format("Column '{}': value does not match type {}", m_name, AnyColumnarSheet::toString(m_type)) };
+            }
+            return *values;
+        }
+
+        // =============================================================================
+        // formatting of a single value, without temporary strings
+
+        template <typename T>
+        static void appendNumber(std::string& buffer, T value)
+        {
+            char chars[32];
+            const auto [end, ec] { std::to_chars(chars, chars + sizeof(chars), value) };
+            buffer.append(chars, end);
+        }
+
+        static void appendCell(std::string& buffer, std::int64_t value) { appendNumber(buffer, value); }
+        static void appendCell(std::string& buffer, double value) { appendNumber(buffer, value); }
+        static void appendCell(std::string& buffer, bool value) { buffer.append(value ? "true" : "false"); }
+
+        // CSV: quoted, if necessary
+        static void appendCell(std::string& buffer, std::string_view value)
+        {
+            if (value.find_first_of(",\"\n") == std::string_view::npos) {
+                buffer.append(value);
+                return;
+            }
+
+            buffer.push_back('"');
+            for (char ch : value) {
+                if (ch == '"') {
+                    buffer.push_back('"');
+                }
+                buffer.push_back(ch);
+            }
+            buffer.push_back('"');
+        }
+    };
+
+    // =================================================================================
+    // Sheet
+    // =================================================================================
+
+    class Sheet
+    {
+    private:
+        static constexpr std::size_t BlockSize{ 1024 };     // rows formatted per column dispatch
+
+        std::vector<Column> m_columns;
+        std::size_t         m_rows{};
+
+    public:
+        Sheet(std::initializer_list<std::pair<std::string_view, ColumnType>> columns)
+        {
+            for (const auto& [name, type] : columns) {
+                m_columns.emplace_back(name, type);
+            }
+        }
+
+        std::size_t rows() const noexcept { return m_rows; }
+        std::size_t columns() const noexcept { return m_columns.size(); }
+
+        const Column& column(std::size_t index) const { return m_columns[index]; }
+
+        void reserve(std::size_t rows) {
+            for (auto& column : m_columns) {
+                column.reserve(rows);
+            }
+        }
+
+        // one value per column, std::nullopt for a missing value -
+        // all values are checked before the first one is appended
+        template <typename... TValues>
+        void appendRow(const TValues&... values)
+        {
+            if (sizeof...(TValues) != m_columns.size()) {
+                throw std::invalid_argument{ "Sheet: number of values does not match number of columns" };
+            }
+
+            std::size_t index{};
+            const bool valid{ (matches<TValues>(m_columns[index++].type()) && ...) };
+            if (!valid) {
+                const Column& column{ m_columns[index - 1] };
+                throw std::invalid_argument{ std::format("Column '{}': value does not match type {}", column.name(), AnyColumnarSheet::toString(column.type())) };
+            }
+
+            index = 0;
+            (appendValue(m_columns[index++], values), ...);
+            ++m_rows;
+        }
+
+        std::string toString(std::size_t row, std::size_t column) const {
+            return m_columns[column].toString(row);
+        }
+
+        // bulk export: the rows are processed in blocks, each column
+        // formats a whole block after a single type dispatch
+        void writeCsv(std::string& out) const
+        {
+            for (std::size_t col{}; col != m_columns.size(); ++col) {
+                out.append(m_columns[col].name());
+                out.push_back(col + 1 != m_columns.size() ? ',' : '\n');
+            }
+
+            std::vector<std::string> buffers(m_columns.size());
+            std::vector<std::vector<std::size_t>> ends(m_columns.size());
+
+            for (std::size_t first{}; first < m_rows; first += BlockSize) {
+
+                const std::size_t count{ std::min(BlockSize, m_rows - first) };
+
+                for (std::size_t col{}; col != m_columns.size(); ++col) {
+                    buffers[col].clear();
+                    ends[col].clear();
+                    m_columns[col].formatBlock(first, count, buffers[col], ends[col]);
+                }
+
+                for (std::size_t row{}; row != count; ++row) {
+                    for (std::size_t col{}; col != m_columns.size(); ++col) {
+                        const std::size_t begin{ row == 0 ? 0 : ends[col][row - 1] };
+                        out.append(buffers[col], begin, ends[col][row] - begin);
+                        out.push_back(col + 1 != m_columns.size() ? ',' : '\n');
+                    }
+                }
+            }
+        }
+
+    private:
+        template <typename T>
+        static void appendValue(Column& column, const T& value)
+        {
+            if constexpr (std::is_same_v<T, std::nullopt_t>) {
+                column.appendNull();
+            }
+            else {
+                column.append(value);
+            }
+        }
+    };
+
+    // =================================================================================
+    // sheet with std::any cells, as in Any.cpp (toString extended by
+    // std::int64_t, missing values and a CSV export)
+    // =================================================================================
+
+    using AnyRow = std::tuple<std::any, std::any, std::any, std::any>;
+
+    static std::string toString(const std::any& var)
+    {
+        if (!var.has_value()) {
+            return std::string{};
+        }
+        else if (var.type() == typeid (int)) {
+            return std::to_string(std::any_cast<int>(var));
+        }
+        else if (var.type() == typeid (std::int64_t)) {
+            return std::to_string(std::any_cast<std::int64_t>(var));
+        }
+        else if (var.type() == typeid (double)) {
+            return std::to_string(std::any_cast<double>(var));
+        }
+        else if (var.type() == typeid (bool)) {
+            return std::to_string(std::any_cast<bool>(var));
+        }
+        else if (var.type() == typeid (char)) {
+            return std::to_string(std::any_cast<char>(var));
+        }
+        else if (var.type() == typeid (std::string)) {
+            return std::any_cast<std::string>(var);
+        }
+        else {
+            return std::string("<Unknown>");
+        }
+    }
+
+    static void writeCsv(const std::vector<AnyRow>& sheet, std::string& out)
+    {
+        out.append("Id,Price,Available,Name\n");
+
+        for (const auto& [val1, val2, val3, val4] : sheet) {
+            out.append(toString(val1));
+            out.push_back(',');
+            out.append(toString(val2));
+            out.push_back(',');
+            out.append(toString(val3));
+            out.push_back(',');
+            out.append(toString(val4));
+            out.push_back('\n');
+        }
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        Sheet sheet{
+            { "Id", ColumnType::Int64 },
+            { "Price", ColumnType::Double },
+            { "Available", ColumnType::Bool },
+            { "Name", ColumnType::String }
+        };
+
+        sheet.appendRow(1, 99.99, true, "ABC");
+        sheet.appendRow(2, std::nullopt, false, "Comma, \"quoted\"");
+        sheet.appendRow(3, 1.5, true, std::optional<std::string>{});
+
+        try {
+            sheet.appendRow(4, "wrong type", true, "XYZ");
+        }
+        catch (const std::invalid_argument& ex) {
+            std::println("{}", ex.what());
+        }
+
+        for (std::size_t col{}; col != sheet.columns(); ++col) {
+            const Column& column{ sheet.column(col) };
+            std::println("Column {}: {} - {} values, {} missing",
+                column.name(), toString(column.type()), column.size(), column.nullCount());
+        }
+
+        std::println("Cell (0, 1): {}", sheet.toString(0, 1));
+
+        std::string csv{};
+        sheet.writeCsv(csv);
+        std::print("{}", csv);
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumRows = 100'000;        // debug
+#else
+    static constexpr std::size_t NumRows = 1'000'000;      // release
+#endif
+
+    static constexpr std::array<std::string_view, 4> Names{
+        "Mueller", "Sepp", "Hans-Joachim Friedrichsen", "Anna-Lena Oberhuber-Schmidt"
+    };
+
+    static void test_02()
+    {
+        std::println("{} rows - {} cells:", NumRows, NumRows * 4);
+
+        std::vector<AnyRow> anySheet{};
+        Sheet sheet{
+            { "Id", ColumnType::Int64 },
+            { "Price", ColumnType::Double },
+            { "Available", ColumnType::Bool },
+            { "Name", ColumnType::String }
+        };
+
+        {
+            std::println("Filling std::vector<std::tuple<std::any, ...>>:");
+            ScopedTimer watch{};
+
+            anySheet.reserve(NumRows);
+
+            std::mt19937 engine{ 42 };
+            for (std::size_t i{}; i != NumRows; ++i) {
+                const double price{ static_cast<double>(engine() % 100'000) / 100.0 };
+                anySheet.emplace_back(
+                    static_cast<std::int64_t>(i),
+                    i % 100 == 0 ? std::any{} : std::any{ price },
+                    i % 3 == 0,
+                    std::string{ Names[i % Names.size()] }
+                );
+            }
+        }
+
+        {
+            std::println("Filling Sheet:");
+            ScopedTimer watch{};
+
+            sheet.reserve(NumRows);
+
+            std::mt19937 engine{ 42 };
+            for (std::size_t i{}; i != NumRows; ++i) {
+                const double price{ static_cast<double>(engine() % 100'000) / 100.0 };
+                sheet.appendRow(
+                    static_cast<std::int64_t>(i),
+                    i % 100 == 0 ? std::optional<double>{} : std::optional<double>{ price },
+                    i % 3 == 0,
+                    Names[i % Names.size()]
+                );
+            }
+        }
+
+        {
+            std::println("Sum of prices, std::any:");
+            double sum{};
+            {
+                ScopedTimer watch{};
+                for (const auto& row : anySheet) {
+                    if (const double* price{ std::any_cast<double>(&std::get<1>(row)) }) {
+                        sum += *price;
+                    }
+                }
+            }
+            std::println("Sum: {:.2f}", sum);
+        }
+
+        {
+            std::println("Sum of prices, Sheet:");
+            double sum{};
+            {
+                ScopedTimer watch{};
+                // missing values are stored as 0.0
+                const auto prices{ sheet.column(1).doubleValues() };
+                sum = std::accumulate(prices.begin(), prices.end(), 0.0);
+            }
+            std::println("Sum: {:.2f}", sum);
+        }
+
+        {
+            std::println("CSV export, std::any:");
+            std::string csv{};
+            {
+                ScopedTimer watch{};
+                writeCsv(anySheet, csv);
+            }
+            std::println("Characters: {}", csv.size());
+        }
+
+        {
+            std::println("CSV export, Sheet:");
+            std::string csv{};
+            {
+                ScopedTimer watch{};
+                sheet.writeCsv(csv);
+            }
+            std::println("Characters: {}", csv.size());
+        }
+    }
+}
+
+void main_any_columnar_sheet()
+{
+    using namespace AnyColumnarSheet;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,7 @@
 export module modern_cpp:any;
 
 export void main_any();
+export void main_any_columnar_sheet();
 
 // =====================================================================================
 // End-of-File
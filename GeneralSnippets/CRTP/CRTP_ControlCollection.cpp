@@ -0,0 +1,411 @@
+// =====================================================================================
+// CRTP_ControlCollection.cpp // Controls stored per type, drawn without virtual calls
+// =====================================================================================
+
+module modern_cpp:crtp;
+
+import std;
+
+namespace CRTPControlCollection {
+
+    // =================================================================================
+    // drawControls in CRTP.cpp iterates a std::vector<std::shared_ptr<ControlBase>>:
+    // one virtual call per control, every control in its own heap block.
+    // ControlCollection stores the controls in one contiguous std::vector per type
+    // and calls draw with static (CRTP) dispatch. An additional index remembers
+    // the insertion order for the cases where the order of drawing matters.
+    // =================================================================================
+
+    // simulated drawing surface: collects a checksum of all drawing operations
+    class Canvas
+    {
+    private:
+        std::uint64_t m_checksum{};
+        std::size_t   m_operations{};
+
+    public:
+        void fill(int x, int y, int width, int height, std::uint32_t color) noexcept {
+            m_checksum += static_cast<std::uint64_t>(x * 31 + y) * color + static_cast<std::uint64_t>(width * height);
+            ++m_operations;
+        }
+
+        void text(int x, int y, std::string_view text) noexcept {
+            m_checksum += static_cast<std::uint64_t>(x + y) ^ text.size();
+            ++m_operations;
+        }
+
+        std::uint64_t checksum() const noexcept { return m_checksum; }
+        std::size_t operations() const noexcept { return m_operations; }
+    };
+
+    class ControlBase
+    {
+    public:
+        virtual void draw(Canvas& canvas) = 0;
+        virtual ~ControlBase() {}
+    };
+
+    template <class T>
+    class Control : public ControlBase  // inheritance needed for 'container' example
+    {
+    protected:
+        int m_x;
+        int m_y;
+        int m_width;
+        int m_height;
+
+    public:
+        Control(int x, int y, int width, int height)
+            : m_x{ x }, m_y{ y }, m_width{ width }, m_height{ height }
+        {}
+
+        void draw(Canvas& canvas) override
+        {
+            static_cast<T*>(this)->eraseBackground(canvas);
+            static_cast<T*>(this)->paint(canvas);
+        }
+    };
+
+    class Button final : public Control<Button>
+    {
+    private:
+        std::string_view m_caption;
+
+    public:
+        Button(int x, int y, std::string_view caption)
+            : Control{ x, y, 80, 24 }, m_caption{ caption }
+        {}
+
+        static constexpr std::string_view name() { return "Button"; }
+
+        void eraseBackground(Canvas& canvas) {
+            canvas.fill(m_x, m_y, m_width, m_height, 0xC0C0C0);
+        }
+
+        void paint(Canvas& canvas) {
+            canvas.text(m_x + 4, m_y + 4, m_caption);
+        }
+    };
+
+    class Checkbox final : public Control<Checkbox>
+    {
+    private:
+        bool m_checked;
+
+    public:
+        Checkbox(int x, int y, bool checked)
+            : Control{ x, y, 16, 16 }, m_checked{ checked }
+        {}
+
+        static constexpr std::string_view name() { return "Checkbox"; }
+
+        void eraseBackground(Canvas& canvas) {
+            canvas.fill(m_x, m_y, m_width, m_height, 0xFFFFFF);
+        }
+
+        void paint(Canvas& canvas) {
+            if (m_checked) {
+                canvas.fill(m_x + 3, m_y + 3, m_width - 6, m_height - 6, 0x000000);
+            }
+        }
+    };
+
+    class Slider final : public Control<Slider>
+    {
+    private:
+        int m_value;     // 0 ... 100
+
+    public:
+        Slider(int x, int y, int value)
+            : Control{ x, y, 120, 20 }, m_value{ value }
+        {}
+
+        static constexpr std::string_view name() { return "Slider"; }
+
+        void eraseBackground(Canvas& canvas) {
+            canvas.fill(m_x, m_y, m_width, m_height, 0xE0E0E0);
+        }
+
+        void paint(Canvas& canvas) {
+            canvas.fill(m_x + m_value * (m_width - 8) / 100, m_y, 8, m_height, 0x404040);
+        }
+    };
+
+    // =================================================================================
+    // ControlCollection<TControls...>
+    //
+    // Further Control<T> derivatives are supported by extending the list of types.
+    // Note: like std::vector::emplace_back, emplace invalidates references to
+    // controls of the same type.
+    // =================================================================================
+
+    template <typename... TControls>
+    class ControlCollection
+    {
+    private:
+        // position of a control: type and index in the vector of this type
+        struct Entry
+        {
+            std::uint32_t type;
+            std::uint32_t index;
+        };
+
+        std::tuple<std::vector<TControls>...> m_controls;
+        std::vector<Entry>                    m_order;     // insertion order
+
+        template <typename T>
+        static constexpr std::size_t typeIndex()
+        {
+            constexpr std::array<bool, sizeof...(TControls)> matches{ std::is_same_v<T, TControls> ... };
+
+            for (std::size_t i{}; i != matches.size(); ++i) {
+                if (matches[i]) {
+                    return i;
+                }
+            }
+            return matches.size();
+        }
+
+        // qualified call: no virtual dispatch, even though Control<T>::draw is virtual
+        template <typename T>
+        static void drawOne(T& control, Canvas& canvas) {
+            control.Control<T>::draw(canvas);
+        }
+
+        template <std::size_t... Is, typename TFunc>
+        void visitEntry(Entry entry, TFunc& func, std::index_sequence<Is...>)
+        {
+            // fold expression selects the vector of the entry's type
+            static_cast<void>(((entry.type == Is && (func(std::get<Is>(m_controls)[entry.index]), true)) || ...));
+        }
+
+    public:
+        template <typename T, typename... TArgs>
+            requires (std::is_same_v<T, TControls> || ...)
+        T& emplace(TArgs&&... args)
+        {
+            auto& controls{ std::get<std::vector<T>>(m_controls) };
+
+            T& control{ controls.emplace_back(std::forward<TArgs>(args)...) };
+
+            try {
+                m_order.push_back({ static_cast<std::uint32_t>(typeIndex<T>()), static_cast<std::uint32_t>(controls.size() - 1) });
+            }
+            catch (...) {
+                controls.pop_back();    // no inconsistency if push_back throws
+                throw;
+            }
+
+            return control;
+        }
+
+        template <typename T>
+            requires (std::is_same_v<T, TControls> || ...)
+        std::span<T> controls() noexcept {
+            return std::get<std::vector<T>>(m_controls);
+        }
+
+        std::size_t size() const noexcept { return m_order.size(); }
+        bool empty() const noexcept { return m_order.empty(); }
+
+        void reserve(std::size_t count) {
+            m_order.reserve(count);
+        }
+
+        template <typename T>
+            requires (std::is_same_v<T, TControls> || ...)
+        void reserve(std::size_t count) {
+            std::get<std::vector<T>>(m_controls).reserve(count);
+        }
+
+        void clear() noexcept
+        {
+            std::apply([](auto&... controls) { (controls.clear(), ...); }, m_controls);
+            m_order.clear();
+        }
+
+        // all controls of one type after the other - fastest, order of the types
+        template <typename TFunc>
+        void forEach(TFunc&& func)
+        {
+            std::apply(
+                [&](auto&... controls) {
+                    ([&] {
+                        for (auto& control : controls) {
+                            func(control);
+                        }
+                    }(), ...);
+                },
+                m_controls
+            );
+        }
+
+        // insertion order
+        template <typename TFunc>
+        void forEachInOrder(TFunc&& func)
+        {
+            for (Entry entry : m_order) {
+                visitEntry(entry, func, std::index_sequence_for<TControls...>{});
+            }
+        }
+
+        void draw(Canvas& canvas) {
+            forEach([&](auto& control) { drawOne(control, canvas); });
+        }
+
+        void drawInOrder(Canvas& canvas) {
+            forEachInOrder([&](auto& control) { drawOne(control, canvas); });
+        }
+    };
+
+    using Controls = ControlCollection<Button, Checkbox, Slider>;
+
+    // =================================================================================
+    // classical approach (as in CRTP.cpp)
+    // =================================================================================
+
+    static void drawControls(std::vector<std::shared_ptr<ControlBase>>& controls, Canvas& canvas) {
+
+        for (auto& control : controls) {
+            control->draw(canvas);
+        }
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static constexpr std::array<std::string_view, 4> Captions{ "OK", "Cancel", "Apply", "Help" };
+
+    // the same random sequence of controls for both containers
+    template <typename TAdd>
+    static void createControls(std::size_t count, TAdd add)
+    {
+        std::mt19937 engine{ 42 };
+
+        for (std::size_t i{}; i != count; ++i) {
+
+            const int x{ static_cast<int>(engine() % 1920) };
+            const int y{ static_cast<int>(engine() % 1080) };
+
+            switch (engine() % 3)
+            {
+            case 0:
+                add(Button{ x, y, Captions[i % Captions.size()] });
+                break;
+            case 1:
+                add(Checkbox{ x, y, i % 2 == 0 });
+                break;
+            default:
+                add(Slider{ x, y, static_cast<int>(i % 101) });
+                break;
+            }
+        }
+    }
+
+    static void test_01()
+    {
+        Controls controls{};
+
+        controls.emplace<Checkbox>(10, 10, true);
+        controls.emplace<Button>(10, 40, "OK");
+        controls.emplace<Slider>(10, 70, 50);
+        controls.emplace<Button>(100, 40, "Cancel");
+
+        std::println("Controls: {} - Buttons: {}", controls.size(), controls.controls<Button>().size());
+
+        std::print("By type:          ");
+        controls.forEach([](const auto& control) {
+            std::print("{} ", control.name());
+        });
+        std::println();
+
+        std::print("Insertion order:  ");
+        controls.forEachInOrder([](const auto& control) {
+            std::print("{} ", control.name());
+        });
+        std::println();
+
+        // same drawing operations as with virtual calls
+        Canvas canvas1{};
+        Canvas canvas2{};
+
+        std::vector<std::shared_ptr<ControlBase>> vector{};
+        createControls(1000, [&](auto control) { vector.push_back(std::make_shared<decltype(control)>(control)); });
+        drawControls(vector, canvas1);
+
+        controls.clear();
+        createControls(1000, [&](auto control) { controls.emplace<decltype(control)>(control); });
+        controls.drawInOrder(canvas2);
+
+        std::println("Checksums: {} - {}", canvas1.checksum(), canvas2.checksum());
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t DrawBudget = 10'000'000;       // debug, controls drawn per measurement
+#else
+    static constexpr std::size_t DrawBudget = 200'000'000;      // release, controls drawn per measurement
+#endif
+
+    static constexpr std::array<std::size_t, 3> NumControls{ 10'000, 100'000, 1'000'000 };
+
+    template <typename TDraw>
+    static void measure(std::string_view label, std::size_t count, TDraw draw)
+    {
+        const std::size_t frames{ std::max(DrawBudget / count, std::size_t{ 1 }) };
+        Canvas canvas{};
+
+        const auto start{ std::chrono::steady_clock::now() };
+        for (std::size_t i{}; i != frames; ++i) {
+            draw(canvas);
+        }
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double> seconds{ end - start };
+        std::println("  {:<44}{:8.1f} million controls/s  (checksum {})",
+            label, static_cast<double>(frames * count) / seconds.count() / 1e6, canvas.checksum());
+    }
+
+    static void test_02()
+    {
+        for (auto count : NumControls) {
+
+            std::println("{} controls:", count);
+
+            std::vector<std::shared_ptr<ControlBase>> vector{};
+            vector.reserve(count);
+            createControls(count, [&](auto control) { vector.push_back(std::make_shared<decltype(control)>(control)); });
+
+            Controls controls{};
+            controls.reserve(count);
+            createControls(count, [&](auto control) { controls.emplace<decltype(control)>(control); });
+
+            measure("std::vector<std::shared_ptr<ControlBase>>:", count, [&](Canvas& canvas) {
+                drawControls(vector, canvas);
+            });
+
+            measure("ControlCollection (grouped by type):", count, [&](Canvas& canvas) {
+                controls.draw(canvas);
+            });
+
+            measure("ControlCollection (insertion order):", count, [&](Canvas& canvas) {
+                controls.drawInOrder(canvas);
+            });
+        }
+    }
+}
+
+void main_crtp_control_collection()
+{
+    using namespace CRTPControlCollection;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -0,0 +1,652 @@
+// =====================================================================================
+// CRTP_ImagePipeline.cpp // CRTP painters drawing whole scanlines of real RGBA images
+// =====================================================================================
+
+module;
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define IMAGE_PIPELINE_SSE2
+#if defined(__AVX2__)
+#define IMAGE_PIPELINE_AVX2
+#endif
+#endif
+
+module modern_cpp:crtp;
+
+import std;
+
+namespace CRTPImagePipeline {
+
+    // =================================================================================
+    // The CRTP benchmark in Exercises_10_CRTP.cpp calls drawPixel once per pixel,
+    // but drawPixel touches no memory - only the cost of the dispatch is measured.
+    // Here the painters write into real pixel buffers. CRTP allows a painter to
+    // replace the per-pixel path by kernels processing a complete scanline:
+    // simple loops over contiguous memory (fill, copy), the blending of
+    // BlendPainter with SSE2 / AVX2 kernels as in StringView_Scanning.cpp.
+    // =================================================================================
+
+    struct Rgba
+    {
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
+        std::uint8_t a;
+
+        bool operator== (const Rgba&) const = default;
+    };
+
+    static_assert(sizeof(Rgba) == 4);
+
+    struct Rect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    // =================================================================================
+    // image buffers: interleaved (RGBARGBA...) and planar (RR... GG... BB... AA...)
+    // =================================================================================
+
+    class InterleavedImage
+    {
+    private:
+        int               m_width;
+        int               m_height;
+        std::vector<Rgba> m_pixels;
+
+    public:
+        using Row = std::span<Rgba>;
+
+        InterleavedImage(int width, int height)
+            : m_width{ width }, m_height{ height }, m_pixels(static_cast<std::size_t>(width) * height)
+        {}
+
+        int width() const noexcept { return m_width; }
+        int height() const noexcept { return m_height; }
+
+        Row row(int y) noexcept {
+            return { m_pixels.data() + static_cast<std::size_t>(y) * m_width, static_cast<std::size_t>(m_width) };
+        }
+
+        Rgba at(int x, int y) const noexcept {
+            return m_pixels[static_cast<std::size_t>(y) * m_width + x];
+        }
+    };
+
+    // one scanline of a planar image
+    struct PlanarRow
+    {
+        std::span<std::uint8_t> r;
+        std::span<std::uint8_t> g;
+        std::span<std::uint8_t> b;
+        std::span<std::uint8_t> a;
+
+        std::size_t size() const noexcept { return r.size(); }
+
+        PlanarRow subspan(std::size_t offset, std::size_t count) const noexcept {
+            return { r.subspan(offset, count), g.subspan(offset, count), b.subspan(offset, count), a.subspan(offset, count) };
+        }
+    };
+
+    class PlanarImage
+    {
+    private:
+        int                       m_width;
+        int                       m_height;
+        std::size_t               m_planeSize;
+        std::vector<std::uint8_t> m_planes;      // all four planes in one allocation
+
+    public:
+        using Row = PlanarRow;
+
+        PlanarImage(int width, int height)
+            : m_width{ width },
+              m_height{ height },
+              m_planeSize{ static_cast<std::size_t>(width) * height },
+              m_planes(4 * m_planeSize)
+        {}
+
+        int width() const noexcept { return m_width; }
+        int height() const noexcept { return m_height; }
+
+        Row row(int y) noexcept
+        {
+            const std::size_t width{ static_cast<std::size_t>(m_width) };
+            std::uint8_t* first{ m_planes.data() + static_cast<std::size_t>(y) * width };
+
+            return {
+                { first, width },
+                { first + m_planeSize, width },
+                { first + 2 * m_planeSize, width },
+                { first + 3 * m_planeSize, width }
+            };
+        }
+
+        Rgba at(int x, int y) const noexcept
+        {
+            const std::size_t index{ static_cast<std::size_t>(y) * m_width + x };
+
+            return {
+                m_planes[index],
+                m_planes[index + m_planeSize],
+                m_planes[index + 2 * m_planeSize],
+                m_planes[index + 3 * m_planeSize]
+            };
+        }
+    };
+
+    // =================================================================================
+    // Painter<T>: CRTP base class of all painters
+    //
+    // T provides   Rgba shade(int x, int y, Rgba dst) const
+    // T may add    drawRow(InterleavedImage::Row, int x, int y) const and
+    //              drawRow(PlanarImage::Row, int x, int y) const
+    //              processing a complete scanline
+    // =================================================================================
+
+    template <typename T>
+    class Painter
+    {
+    public:
+        // default row kernels: one pixel after the other
+        void drawRow(InterleavedImage::Row row, int x, int y) const { drawPixels(row, x, y); }
+        void drawRow(PlanarImage::Row row, int x, int y) const { drawPixels(row, x, y); }
+
+        template <typename TImage>
+        void drawRect(TImage& image, Rect rect) const
+        {
+            rect = clip(image, rect);
+
+            for (int y{ rect.y }; y != rect.y + rect.height; ++y) {
+                auto row{ image.row(y).subspan(static_cast<std::size_t>(rect.x), static_cast<std::size_t>(rect.width)) };
+                static_cast<const T*>(this)->drawRow(row, rect.x, y);  // dispatch call to exact type
+            }
+        }
+
+        template <typename TImage>
+        void draw(TImage& image) const {
+            drawRect(image, { 0, 0, image.width(), image.height() });
+        }
+
+        // reference: per-pixel path, even if T has row kernels
+        template <typename TImage>
+        void drawPixelwise(TImage& image) const
+        {
+            for (int y{}; y != image.height(); ++y) {
+                drawPixels(image.row(y), 0, y);
+            }
+        }
+
+    private:
+        void drawPixels(InterleavedImage::Row row, int x, int y) const
+        {
+            const T& painter{ *static_cast<const T*>(this) };
+
+            for (std::size_t i{}; i != row.size(); ++i) {
+                row[i] = painter.shade(x + static_cast<int>(i), y, row[i]);
+            }
+        }
+
+        void drawPixels(PlanarImage::Row row, int x, int y) const
+        {
+            const T& painter{ *static_cast<const T*>(this) };
+
+            for (std::size_t i{}; i != row.size(); ++i) {
+                const Rgba pixel{ painter.shade(x + static_cast<int>(i), y, { row.r[i], row.g[i], row.b[i], row.a[i] }) };
+                row.r[i] = pixel.r;
+                row.g[i] = pixel.g;
+                row.b[i] = pixel.b;
+                row.a[i] = pixel.a;
+            }
+        }
+
+        template <typename TImage>
+        static Rect clip(const TImage& image, Rect rect) noexcept
+        {
+            const int left{ std::clamp(rect.x, 0, image.width()) };
+            const int top{ std::clamp(rect.y, 0, image.height()) };
+            const int right{ std::clamp(rect.x + rect.width, left, image.width()) };
+            const int bottom{ std::clamp(rect.y + rect.height, top, image.height()) };
+
+            return { left, top, right - left, bottom - top };
+        }
+    };
+
+    // =================================================================================
+    // GradientPainter: red grows from left to right, green from top to bottom
+    // =================================================================================
+
+    class GradientPainter : public Painter<GradientPainter>
+    {
+    private:
+        std::vector<std::uint8_t> m_red;     // red depends on x only: one scanline, computed once
+        std::uint32_t             m_scaleY;  // 16.16 fixed point: 255 / (height - 1)
+
+        static std::uint32_t scale(int size) {
+            return size > 1 ? (255u << 16) / static_cast<std::uint32_t>(size - 1) : 0;
+        }
+
+        static std::uint8_t ramp(int position, std::uint32_t scale) {
+            return static_cast<std::uint8_t>((static_cast<std::uint32_t>(position) * scale + 0x8000) >> 16);
+        }
+
+    public:
+        static constexpr std::uint8_t Blue{ 128 };
+
+        GradientPainter(int width, int height) : m_red(static_cast<std::size_t>(width)), m_scaleY{ scale(height) }
+        {
+            const std::uint32_t scaleX{ scale(width) };
+            for (int x{}; x != width; ++x) {
+                m_red[static_cast<std::size_t>(x)] = ramp(x, scaleX);
+            }
+        }
+
+        Rgba shade(int x, int y, Rgba) const {
+            return { m_red[static_cast<std::size_t>(x)], ramp(y, m_scaleY), Blue, 255 };
+        }
+
+        void drawRow(InterleavedImage::Row row, int x, int y) const
+        {
+            const std::uint8_t* red{ m_red.data() + x };
+            const std::uint8_t green{ ramp(y, m_scaleY) };
+
+            for (std::size_t i{}; i != row.size(); ++i) {
+                row[i] = { red[i], green, Blue, 255 };
+            }
+        }
+
+        void drawRow(PlanarImage::Row row, int x, int y) const
+        {
+            std::copy_n(m_red.data() + x, row.size(), row.r.data());
+            std::fill(row.g.begin(), row.g.end(), ramp(y, m_scaleY));
+            std::fill(row.b.begin(), row.b.end(), Blue);
+            std::fill(row.a.begin(), row.a.end(), std::uint8_t{ 255 });
+        }
+    };
+
+    // =================================================================================
+    // BlendPainter: a translucent color drawn over the image (source-over)
+    // =================================================================================
+
+    // v / 255, rounded, exact for 0 <= v <= 255 * 255 - without a division;
+    // all intermediate values fit into 16 bits: 16 lanes per 256-bit register
+    constexpr std::uint16_t divide255(std::uint16_t v) noexcept
+    {
+        v = static_cast<std::uint16_t>(v + 128);
+        return static_cast<std::uint16_t>((v + (v >> 8)) >> 8);
+    }
+
+    static_assert(divide255(255 * 255) == 255);
+    static_assert(divide255(127) == 0 && divide255(128) == 1);
+
+    // =================================================================================
+    // SIMD kernels: dest = divide255(source + dest * inverse) for 16 / 32 bytes,
+    // the bytes are widened to 16-bit lanes - source holds the value per lane:
+    // the 4 channels of 2 pixels (interleaved) or one value (planar)
+    // =================================================================================
+
+#if defined(IMAGE_PIPELINE_SSE2)
+
+    static __m128i divide255x8(__m128i v)
+    {
+        v = _mm_add_epi16(v, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+    }
+
+    static __m128i blend128(__m128i dest, __m128i source, __m128i inverse)
+    {
+        const __m128i zero{ _mm_setzero_si128() };
+
+        const __m128i low{ divide255x8(_mm_add_epi16(source, _mm_mullo_epi16(_mm_unpacklo_epi8(dest, zero), inverse))) };
+        const __m128i high{ divide255x8(_mm_add_epi16(source, _mm_mullo_epi16(_mm_unpackhi_epi8(dest, zero), inverse))) };
+
+        return _mm_packus_epi16(low, high);
+    }
+
+#endif
+
+#if defined(IMAGE_PIPELINE_AVX2)
+
+    static __m256i divide255x16(__m256i v)
+    {
+        v = _mm256_add_epi16(v, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+    }
+
+    // unpack and pack work per 128-bit lane: the order of the bytes is kept
+    static __m256i blend256(__m256i dest, __m256i source, __m256i inverse)
+    {
+        const __m256i zero{ _mm256_setzero_si256() };
+
+        const __m256i low{ divide255x16(_mm256_add_epi16(source, _mm256_mullo_epi16(_mm256_unpacklo_epi8(dest, zero), inverse))) };
+        const __m256i high{ divide255x16(_mm256_add_epi16(source, _mm256_mullo_epi16(_mm256_unpackhi_epi8(dest, zero), inverse))) };
+
+        return _mm256_packus_epi16(low, high);
+    }
+
+#endif
+
+    class BlendPainter : public Painter<BlendPainter>
+    {
+    private:
+        std::array<std::uint16_t, 4> m_source;      // color * alpha, the alpha "channel" blends with 255
+        std::uint16_t                m_inverse;     // 255 - alpha
+
+        static std::uint8_t blend(std::uint16_t source, std::uint16_t inverse, std::uint8_t dest) {
+            return static_cast<std::uint8_t>(divide255(static_cast<std::uint16_t>(source + dest * inverse)));
+        }
+
+        static std::uint16_t premultiply(std::uint8_t channel, std::uint8_t alpha) {
+            return static_cast<std::uint16_t>(channel * alpha);
+        }
+
+        // blends count bytes, source[i % 4] belongs to byte i - chunks of
+        // 16 / 32 bytes start at multiples of 4: one pattern for all chunks
+        static void blendBytes(std::uint8_t* bytes, std::size_t count, const std::array<std::uint16_t, 4>& source, std::uint16_t inverse)
+        {
+            std::size_t i{};
+
+#if defined(IMAGE_PIPELINE_AVX2)
+            {
+                const __m256i sources{ _mm256_setr_epi16(
+                    source[0], source[1], source[2], source[3], source[0], source[1], source[2], source[3],
+                    source[0], source[1], source[2], source[3], source[0], source[1], source[2], source[3]) };
+                const __m256i inverses{ _mm256_set1_epi16(static_cast<short>(inverse)) };
+
+                for (; i + 32 <= count; i += 32) {
+                    __m256i* chunk{ reinterpret_cast<__m256i*>(bytes + i) };
+                    _mm256_storeu_si256(chunk, blend256(_mm256_loadu_si256(chunk), sources, inverses));
+                }
+            }
+#endif
+
+#if defined(IMAGE_PIPELINE_SSE2)
+            {
+                const __m128i sources{ _mm_setr_epi16(
+                    source[0], source[1], source[2], source[3], source[0], source[1], source[2], source[3]) };
+                const __m128i inverses{ _mm_set1_epi16(static_cast<short>(inverse)) };
+
+                for (; i + 16 <= count; i += 16) {
+                    __m128i* chunk{ reinterpret_cast<__m128i*>(bytes + i) };
+                    _mm_storeu_si128(chunk, blend128(_mm_loadu_si128(chunk), sources, inverses));
+                }
+            }
+#endif
+
+            // scalar fallback and tail
+            for (; i != count; ++i) {
+                bytes[i] = blend(source[i % 4], inverse, bytes[i]);
+            }
+        }
+
+        static void blendPlane(std::span<std::uint8_t> plane, std::uint16_t source, std::uint16_t inverse)
+        {
+            blendBytes(plane.data(), plane.size(), { source, source, source, source }, inverse);
+        }
+
+    public:
+        explicit BlendPainter(Rgba color)
+            : m_source{ premultiply(color.r, color.a), premultiply(color.g, color.a), premultiply(color.b, color.a), premultiply(255, color.a) },
+              m_inverse{ static_cast<std::uint16_t>(255 - color.a) }
+        {}
+
+        Rgba shade(int, int, Rgba dest) const
+        {
+            return {
+                blend(m_source[0], m_inverse, dest.r),
+                blend(m_source[1], m_inverse, dest.g),
+                blend(m_source[2], m_inverse, dest.b),
+                blend(m_source[3], m_inverse, dest.a)
+            };
+        }
+
+        // the scanline as bytes, 4 channels per pixel
+        void drawRow(InterleavedImage::Row row, int, int) const
+        {
+            blendBytes(reinterpret_cast<std::uint8_t*>(row.data()), 4 * row.size(), m_source, m_inverse);
+        }
+
+        void drawRow(PlanarImage::Row row, int, int) const
+        {
+            blendPlane(row.r, m_source[0], m_inverse);
+            blendPlane(row.g, m_source[1], m_inverse);
+            blendPlane(row.b, m_source[2], m_inverse);
+            blendPlane(row.a, m_source[3], m_inverse);
+        }
+    };
+
+    // =================================================================================
+    // classical approach: one virtual call per pixel
+    // =================================================================================
+
+    class VirtualPainter
+    {
+    public:
+        virtual ~VirtualPainter() = default;
+
+        virtual Rgba shade(int x, int y, Rgba dst) const = 0;
+
+        void draw(InterleavedImage& image) const
+        {
+            for (int y{}; y != image.height(); ++y) {
+                auto row{ image.row(y) };
+                for (std::size_t i{}; i != row.size(); ++i) {
+                    row[i] = shade(static_cast<int>(i), y, row[i]);
+                }
+            }
+        }
+    };
+
+    class VirtualGradientPainter : public VirtualPainter
+    {
+    private:
+        GradientPainter m_painter;
+
+    public:
+        VirtualGradientPainter(int width, int height) : m_painter{ width, height } {}
+
+        Rgba shade(int x, int y, Rgba dst) const override { return m_painter.shade(x, y, dst); }
+    };
+
+    class VirtualBlendPainter : public VirtualPainter
+    {
+    private:
+        BlendPainter m_painter;
+
+    public:
+        explicit VirtualBlendPainter(Rgba color) : m_painter{ color } {}
+
+        Rgba shade(int x, int y, Rgba dst) const override { return m_painter.shade(x, y, dst); }
+    };
+
+    // =================================================================================
+    // multi-threaded rendering: the image is split into tiles,
+    // tiles don't overlap - no synchronization needed
+    // =================================================================================
+
+    template <typename TPainter, typename TImage>
+    static void drawTiled(const TPainter& painter, TImage& image, int tileWidth = 512, int tileHeight = 64)
+    {
+        std::vector<Rect> tiles{};
+
+        for (int y{}; y < image.height(); y += tileHeight) {
+            for (int x{}; x < image.width(); x += tileWidth) {
+                tiles.push_back({ x, y, tileWidth, tileHeight });   // clipped by drawRect
+            }
+        }
+
+        std::for_each(
+            std::execution::par,
+            tiles.begin(),
+            tiles.end(),
+            [&](const Rect& tile) { painter.drawRect(image, tile); }
+        );
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    template <typename TImage>
+    static bool equalImages(const InterleavedImage& expected, const TImage& actual)
+    {
+        for (int y{}; y != expected.height(); ++y) {
+            for (int x{}; x != expected.width(); ++x) {
+                if (expected.at(x, y) != actual.at(x, y)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static void test_01()
+    {
+        constexpr int Width{ 333 };
+        constexpr int Height{ 111 };
+
+        const GradientPainter gradient{ Width, Height };
+        const BlendPainter blend{ { 255, 0, 0, 96 } };
+        const Rect rect{ 50, 20, 1000, 50 };     // partially outside
+
+        // reference: classical polymorphism, per-pixel
+        InterleavedImage reference{ Width, Height };
+        VirtualGradientPainter{ Width, Height }.draw(reference);
+        BlendPainter{ { 255, 0, 0, 96 } }.drawPixelwise(reference);
+
+        InterleavedImage interleaved{ Width, Height };
+        gradient.draw(interleaved);
+        blend.draw(interleaved);
+
+        PlanarImage planar{ Width, Height };
+        gradient.draw(planar);
+        blend.draw(planar);
+
+        InterleavedImage tiled{ Width, Height };
+        drawTiled(gradient, tiled, 64, 16);
+        drawTiled(blend, tiled, 64, 16);
+
+        std::println("Interleaved rows: {}", equalImages(reference, interleaved));
+        std::println("Planar rows:      {}", equalImages(reference, planar));
+        std::println("Tiles:            {}", equalImages(reference, tiled));
+
+        const Rgba pixel{ interleaved.at(Width - 1, Height - 1) };
+        std::println("Pixel ({}, {}): r = {}, g = {}, b = {}, a = {}", Width - 1, Height - 1, pixel.r, pixel.g, pixel.b, pixel.a);
+
+        BlendPainter{ { 0, 0, 255, 255 } }.drawRect(interleaved, rect);
+        const Rgba inside{ interleaved.at(rect.x, rect.y) };
+        const Rgba outside{ interleaved.at(rect.x - 1, rect.y) };
+        std::println("drawRect: inside b = {}, outside b = {}", inside.b, outside.b);
+    }
+
+    // =================================================================================
+    // benchmark: one frame = gradient + blended overlay over the whole image
+    //
+    // Note: tiles pay off only with several cores
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t PixelBudget = 20'000'000;       // debug, per measurement
+#else
+    static constexpr std::size_t PixelBudget = 500'000'000;      // release, per measurement
+#endif
+
+    struct Resolution
+    {
+        std::string_view name;
+        int width;
+        int height;
+    };
+
+    static constexpr std::array<Resolution, 4> Resolutions{ {
+        { "Exercises_10_CRTP", 400, 400 },
+        { "Full HD", 1920, 1080 },
+        { "4K", 3840, 2160 },
+        { "8K", 7680, 4320 }
+    } };
+
+    template <typename TRender>
+    static void measure(std::string_view label, std::size_t pixels, TRender render)
+    {
+        const std::size_t frames{ std::max(PixelBudget / pixels, std::size_t{ 1 }) };
+
+        const auto start{ std::chrono::steady_clock::now() };
+        for (std::size_t i{}; i != frames; ++i) {
+            render();
+        }
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double> seconds{ end - start };
+        std::println("  {:<40}{:10.1f} Mpx/s", label, static_cast<double>(frames * pixels) / seconds.count() / 1e6);
+    }
+
+    static void test_02()
+    {
+        constexpr Rgba Overlay{ 32, 64, 255, 80 };
+
+        for (const auto& [name, width, height] : Resolutions) {
+
+            std::println("{} ({} x {}):", name, width, height);
+
+            const std::size_t pixels{ static_cast<std::size_t>(width) * height };
+
+            const GradientPainter gradient{ width, height };
+            const BlendPainter blend{ Overlay };
+
+            InterleavedImage interleaved{ width, height };
+            PlanarImage planar{ width, height };
+
+            {
+                const VirtualGradientPainter virtualGradient{ width, height };
+                const VirtualBlendPainter virtualBlend{ Overlay };
+                const VirtualPainter& first{ virtualGradient };
+                const VirtualPainter& second{ virtualBlend };
+
+                measure("Classic (virtual, per pixel):", pixels, [&] {
+                    first.draw(interleaved);
+                    second.draw(interleaved);
+                });
+            }
+
+            measure("CRTP (per pixel):", pixels, [&] {
+                gradient.drawPixelwise(interleaved);
+                blend.drawPixelwise(interleaved);
+            });
+
+            measure("CRTP (scanlines, interleaved):", pixels, [&] {
+                gradient.draw(interleaved);
+                blend.draw(interleaved);
+            });
+
+            measure("CRTP (scanlines, planar):", pixels, [&] {
+                gradient.draw(planar);
+                blend.draw(planar);
+            });
+
+            measure("CRTP (scanlines, interleaved, tiles):", pixels, [&] {
+                drawTiled(gradient, interleaved);
+                drawTiled(blend, interleaved);
+            });
+
+            measure("CRTP (scanlines, planar, tiles):", pixels, [&] {
+                drawTiled(gradient, planar);
+                drawTiled(blend, planar);
+            });
+        }
+    }
+}
+
+void main_crtp_image_pipeline()
+{
+    using namespace CRTPImagePipeline;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
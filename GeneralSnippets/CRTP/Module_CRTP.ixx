@@ -5,6 +5,8 @@
 export module modern_cpp:crtp;
 
 export void main_crtp();
+export void main_crtp_image_pipeline();
+export void main_crtp_control_collection();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,419 @@
+// =====================================================================================
+// ConstExpr_LookupTable.cpp // Lookup tables computed at compile time
+// =====================================================================================
+
+module modern_cpp:const_expr;
+
+import std;
+
+namespace ConstExprLookupTable {
+
+    // =================================================================================
+    // MetaProgramming01.cpp computes single values with recursive templates,
+    // ConstExpr_CRC.cpp one table with an immediately invoked lambda.
+    // Here: generic builders, a constexpr function and a domain in,
+    // a std::array out:
+    //
+    // - makeTable<N>(f):              table[i]    = f(i)      for 0 <= i < N
+    // - makeTable<Rows, Cols>(f):     table[i][j] = f(i, j)
+    // - makeSampledTable<N>(f, a, b): N samples of f in [a, b] and linear
+    //                                 interpolation between them
+    //
+    // The builders are consteval, the tables constexpr variables: constant
+    // initialization, the values are part of the binary (read-only data).
+    // No code runs at program start - the static_asserts below prove it,
+    // they only compile if the values are known at compile time.
+    // =================================================================================
+
+    template <std::size_t N, typename TFunc>
+    consteval auto makeTable(TFunc func)
+    {
+        using Value = std::invoke_result_t<TFunc, std::size_t>;
+
+        std::array<Value, N> table{};
+        for (std::size_t i{}; i != N; ++i) {
+            table[i] = func(i);
+        }
+        return table;
+    }
+
+    template <std::size_t Rows, std::size_t Cols, typename TFunc>
+    consteval auto makeTable(TFunc func)
+    {
+        using Value = std::invoke_result_t<TFunc, std::size_t, std::size_t>;
+
+        std::array<std::array<Value, Cols>, Rows> table{};
+        for (std::size_t i{}; i != Rows; ++i) {
+            for (std::size_t j{}; j != Cols; ++j) {
+                table[i][j] = func(i, j);
+            }
+        }
+        return table;
+    }
+
+    // =================================================================================
+    // interpolation helpers
+    // =================================================================================
+
+    // 'index' is a fractional position in the table, clamped to [0, N - 1]
+    template <std::size_t N>
+    constexpr double interpolate(const std::array<double, N>& table, double index) noexcept
+    {
+        static_assert(N >= 2);
+
+        if (index <= 0.0) {
+            return table.front();
+        }
+        if (index >= static_cast<double>(N - 1)) {
+            return table.back();
+        }
+
+        const std::size_t i{ static_cast<std::size_t>(index) };
+        const double t{ index - static_cast<double>(i) };
+        return table[i] + t * (table[i + 1] - table[i]);
+    }
+
+    // bilinear interpolation
+    template <std::size_t Rows, std::size_t Cols>
+    constexpr double interpolate(const std::array<std::array<double, Cols>, Rows>& table, double row, double col) noexcept
+    {
+        static_assert(Rows >= 2);
+
+        row = std::clamp(row, 0.0, static_cast<double>(Rows - 1));
+        const std::size_t i{ std::min(static_cast<std::size_t>(row), Rows - 2) };
+        const double t{ row - static_cast<double>(i) };
+
+        const double upper{ interpolate(table[i], col) };
+        const double lower{ interpolate(table[i + 1], col) };
+        return upper + t * (lower - upper);
+    }
+
+    // function sampled at N equidistant points of [min, max]
+    template <std::size_t N>
+    class SampledTable
+    {
+    private:
+        double                m_min;
+        double                m_max;
+        double                m_scale;      // (N - 1) / (max - min)
+        std::array<double, N> m_values;
+
+    public:
+        constexpr SampledTable(double min, double max, const std::array<double, N>& values)
+            : m_min{ min }, m_max{ max }, m_scale{ static_cast<double>(N - 1) / (max - min) }, m_values{ values }
+        {}
+
+        constexpr double min() const noexcept { return m_min; }
+        constexpr double max() const noexcept { return m_max; }
+        constexpr const std::array<double, N>& values() const noexcept { return m_values; }
+
+        // linear interpolation, x outside of [min, max] is clamped
+        constexpr double operator()(double x) const noexcept {
+            return interpolate(m_values, (x - m_min) * m_scale);
+        }
+
+        // nearest sample, without interpolation
+        constexpr double nearest(double x) const noexcept
+        {
+            const double index{ std::clamp((x - m_min) * m_scale + 0.5, 0.0, static_cast<double>(N - 1)) };
+            return m_values[static_cast<std::size_t>(index)];
+        }
+    };
+
+    template <std::size_t N, typename TFunc>
+    consteval SampledTable<N> makeSampledTable(TFunc func, double min, double max)
+    {
+        static_assert(N >= 2);
+
+        const auto values{ makeTable<N>([&](std::size_t i) {
+            return func(min + (max - min) * static_cast<double>(i) / static_cast<double>(N - 1));
+        }) };
+
+        return { min, max, values };
+    }
+
+    // =================================================================================
+    // constexpr functions for the tables
+    // =================================================================================
+
+    constexpr std::uint64_t factorial(std::size_t n) noexcept
+    {
+        std::uint64_t result{ 1 };
+        for (std::size_t i{ 2 }; i <= n; ++i) {
+            result *= i;
+        }
+        return result;
+    }
+
+    // multiplicative formula, exact for n <= 61 in 64 bits
+    constexpr std::uint64_t binomial(std::size_t n, std::size_t k) noexcept
+    {
+        if (k > n) {
+            return 0;
+        }
+
+        k = std::min(k, n - k);
+
+        std::uint64_t result{ 1 };
+        for (std::size_t i{ 1 }; i <= k; ++i) {
+            result = result * (n - k + i) / i;
+        }
+        return result;
+    }
+
+    constexpr std::uint64_t power(std::uint64_t base, std::size_t exponent) noexcept
+    {
+        std::uint64_t result{ 1 };
+        for (std::size_t i{}; i != exponent; ++i) {
+            result *= base;
+        }
+        return result;
+    }
+
+    // std::sin and std::cos are not constexpr (before C++26):
+    // range reduction to [-pi, pi] and Taylor series
+    constexpr double sinApprox(double x) noexcept
+    {
+        constexpr double Pi{ std::numbers::pi };
+        constexpr double TwoPi{ 2.0 * std::numbers::pi };
+
+        double periods{ (x + Pi) / TwoPi };
+        long long k{ static_cast<long long>(periods) };
+        if (periods < 0.0 && static_cast<double>(k) != periods) {
+            --k;    // floor
+        }
+        x -= static_cast<double>(k) * TwoPi;
+
+        double term{ x };
+        double sum{ x };
+        for (int i{ 1 }; i != 14; ++i) {
+            term *= -x * x / ((2.0 * i) * (2.0 * i + 1.0));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cosApprox(double x) noexcept {
+        return sinApprox(x + std::numbers::pi / 2.0);
+    }
+
+    // CRC-8 (as in ConstExpr_CRC.cpp) and CRC-32 (reflected polynomial)
+    template <std::uint8_t Polynom>
+    constexpr std::uint8_t crc8Entry(std::size_t index) noexcept
+    {
+        std::uint8_t value{ static_cast<std::uint8_t>(index) };
+        for (int j{}; j != 8; ++j) {
+            value = (value & 0x80) != 0 ? static_cast<std::uint8_t>((value << 1) ^ Polynom) : static_cast<std::uint8_t>(value << 1);
+        }
+        return value;
+    }
+
+    template <std::uint32_t Polynom>
+    constexpr std::uint32_t crc32Entry(std::size_t index) noexcept
+    {
+        std::uint32_t value{ static_cast<std::uint32_t>(index) };
+        for (int j{}; j != 8; ++j) {
+            value = (value & 1) != 0 ? (value >> 1) ^ Polynom : value >> 1;
+        }
+        return value;
+    }
+
+    // =================================================================================
+    // the tables
+    // =================================================================================
+
+    static constexpr std::size_t NumSamples{ 1025 };
+
+    static constexpr auto Factorials{ makeTable<21>(factorial) };                  // 20! < 2^64
+    static constexpr auto Binomials{ makeTable<62, 62>(binomial) };
+    static constexpr auto Powers{ makeTable<11, 20>([](std::size_t base, std::size_t exponent) { return power(base, exponent); }) };
+
+    static constexpr auto SinTable{ makeSampledTable<NumSamples>(sinApprox, 0.0, 2.0 * std::numbers::pi) };
+    static constexpr auto CosTable{ makeSampledTable<NumSamples>(cosApprox, 0.0, 2.0 * std::numbers::pi) };
+
+    static constexpr auto Crc8Table{ makeTable<256>(crc8Entry<0x07>) };
+    static constexpr auto Crc32Table{ makeTable<256>(crc32Entry<0xEDB8'8320>) };
+
+    constexpr std::uint8_t crc8(std::string_view data) noexcept
+    {
+        std::uint8_t checksum{};
+        for (char ch : data) {
+            checksum = Crc8Table[static_cast<std::uint8_t>(ch) ^ checksum];
+        }
+        return checksum;
+    }
+
+    constexpr std::uint32_t crc32(std::span<const char> data) noexcept
+    {
+        std::uint32_t checksum{ 0xFFFF'FFFF };
+        for (char ch : data) {
+            checksum = Crc32Table[(checksum ^ static_cast<std::uint8_t>(ch)) & 0xFF] ^ (checksum >> 8);
+        }
+        return ~checksum;
+    }
+
+    // =================================================================================
+    // compile-time tests
+    // =================================================================================
+
+    static_assert(Factorials[0] == 1 && Factorials[10] == 3'628'800);
+    static_assert(Factorials[20] == 2'432'902'008'176'640'000);
+
+    static_assert(Binomials[5][2] == 10 && Binomials[10][11] == 0);
+    static_assert(Binomials[61][30] == 232'714'176'627'630'544);
+    static_assert(Binomials[20][7] == Binomials[19][6] + Binomials[19][7]);       // Pascal
+
+    static_assert(Powers[2][10] == 1024 && Powers[10][19] == 10'000'000'000'000'000'000u);
+
+    static_assert(SinTable(0.0) == 0.0);
+    static_assert(SinTable(std::numbers::pi / 2.0) > 0.999'999 && CosTable(std::numbers::pi) < -0.999'999);
+
+    // check values of CRC-8/SMBUS and CRC-32
+    static_assert(crc8("123456789") == 0xF4);
+    static_assert(crc32(std::string_view{ "123456789" }) == 0xCBF4'3926);
+
+    static_assert(Crc32Table[1] == 0x7707'3096 && Crc8Table[1] == 0x07);
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        std::println("Factorials[15]:       {}", Factorials[15]);
+        std::println("Binomials[49][6]:     {}", Binomials[49][6]);
+        std::println("Powers[3][13]:        {}", Powers[3][13]);
+        std::println("crc8(\"Hello World\"):  {}", crc8("Hello World"));
+
+        // accuracy of the interpolated tables
+        double maxErrorInterpolated{};
+        double maxErrorNearest{};
+
+        for (int i{}; i <= 100'000; ++i) {
+            const double x{ 2.0 * std::numbers::pi * i / 100'000 };
+            maxErrorInterpolated = std::max(maxErrorInterpolated, std::abs(SinTable(x) - std::sin(x)));
+            maxErrorNearest = std::max(maxErrorNearest, std::abs(SinTable.nearest(x) - std::sin(x)));
+        }
+
+        std::println("sin, {} samples - max. error interpolated: {:.2e} - nearest: {:.2e}",
+            NumSamples, maxErrorInterpolated, maxErrorNearest);
+
+        // bilinear interpolation: binomial coefficients as doubles
+        constexpr auto grid{ makeTable<8, 8>([](std::size_t n, std::size_t k) { return static_cast<double>(binomial(n, k)); }) };
+        std::println("Bilinear (4.5, 2.0):  {}", interpolate(grid, 4.5, 2.0));
+    }
+
+    // =================================================================================
+    // benchmark: table lookup vs. computation
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumValues = 1'000'000;        // debug
+#else
+    static constexpr std::size_t NumValues = 20'000'000;       // release
+#endif
+
+    template <typename TFunc>
+    static void measure(std::string_view label, TFunc func)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        const auto result{ func() };
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double, std::milli> elapsed{ end - start };
+        std::println("  {:<36}{:9.2f} ms  (result {})", label, elapsed.count(), result);
+    }
+
+    static void test_02()
+    {
+        std::mt19937 engine{ 42 };
+
+        std::vector<std::size_t> indices(NumValues);
+        std::generate(indices.begin(), indices.end(), [&] { return engine() % 21; });
+
+        std::vector<std::size_t> ks(NumValues);
+        std::generate(ks.begin(), ks.end(), [&] { return engine() % 62; });
+
+        std::vector<double> angles(NumValues);
+        std::uniform_real_distribution<double> distribution{ 0.0, 2.0 * std::numbers::pi };
+        std::generate(angles.begin(), angles.end(), [&] { return distribution(engine); });
+
+        std::println("{} values:", NumValues);
+
+        std::println("Factorial:");
+        measure("computed:", [&] {
+            std::uint64_t sum{};
+            for (auto n : indices) { sum += factorial(n); }
+            return sum;
+        });
+        measure("table:", [&] {
+            std::uint64_t sum{};
+            for (auto n : indices) { sum += Factorials[n]; }
+            return sum;
+        });
+
+        std::println("Binomial coefficient (61, k):");
+        measure("computed:", [&] {
+            std::uint64_t sum{};
+            for (auto k : ks) { sum += binomial(61, k); }
+            return sum;
+        });
+        measure("table:", [&] {
+            std::uint64_t sum{};
+            for (auto k : ks) { sum += Binomials[61][k]; }
+            return sum;
+        });
+
+        std::println("Sine:");
+        measure("std::sin:", [&] {
+            double sum{};
+            for (auto x : angles) { sum += std::sin(x); }
+            return sum;
+        });
+        measure("sinApprox (Taylor series):", [&] {
+            double sum{};
+            for (auto x : angles) { sum += sinApprox(x); }
+            return sum;
+        });
+        measure("table, interpolated:", [&] {
+            double sum{};
+            for (auto x : angles) { sum += SinTable(x); }
+            return sum;
+        });
+        measure("table, nearest sample:", [&] {
+            double sum{};
+            for (auto x : angles) { sum += SinTable.nearest(x); }
+            return sum;
+        });
+
+        std::println("CRC-32 of {} bytes:", NumValues);
+
+        std::vector<char> bytes(NumValues);
+        std::generate(bytes.begin(), bytes.end(), [&] { return static_cast<char>(engine()); });
+
+        measure("computed (bit by bit):", [&] {
+            std::uint32_t checksum{ 0xFFFF'FFFF };
+            for (char ch : bytes) {
+                checksum ^= static_cast<std::uint8_t>(ch);
+                for (int j{}; j != 8; ++j) {
+                    checksum = (checksum & 1) != 0 ? (checksum >> 1) ^ 0xEDB8'8320 : checksum >> 1;
+                }
+            }
+            return ~checksum;
+        });
+        measure("table:", [&] {
+            return crc32(bytes);
+        });
+    }
+}
+
+void main_constexpr_lookup_table()
+{
+    using namespace ConstExprLookupTable;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -7,6 +7,7 @@ export module modern_cpp:const_expr;
 export void main_constexpr();
 export void main_constexpr_02();
 export void main_constexpr_crc();
+export void main_constexpr_lookup_table();
 
 // =====================================================================================
 // End-of-File
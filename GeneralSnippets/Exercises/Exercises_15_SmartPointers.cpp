@@ -394,7 +394,7 @@ namespace Exercises_SmartPointers {
             // copy c'tor
             MyStringUP(const MyStringUP& other) {
 
-                m_length = std::strlen(other.m_string.get());
+                m_length = other.m_length;
                 m_string = std::make_unique<char[]>(m_length + 1);
                 std::memcpy(m_string.get(), other.m_string.get(), m_length + 1);  // copying '\0'
             }
@@ -406,7 +406,7 @@ namespace Exercises_SmartPointers {
                     return *this;
                 }
 
-                m_length = std::strlen(other.m_string.get());
+                m_length = other.m_length;
                 m_string = std::make_unique<char[]>(m_length + 1);
                 std::memcpy(m_string.get(), other.m_string.get(), m_length + 1);  // copying '\0'
 
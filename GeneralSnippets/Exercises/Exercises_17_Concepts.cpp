@@ -2,6 +2,16 @@
 // Exercises_17_Concepts.cpp
 // =====================================================================================
 
+module;
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define CONCEPTS_EXERCISE_SSE2
+#if defined(__AVX2__)
+#define CONCEPTS_EXERCISE_AVX2
+#endif
+#endif
+
 module modern_cpp_exercises:concepts;
 
 import std;
@@ -580,6 +590,425 @@ namespace Exercises_Concepts {
             testExercise_02();
         }
     }
+    namespace Exercise_05 {
+
+        // ---------------------------------------------------------------
+        // Algorithms dispatched by concepts:
+        // the most specific overload is chosen by subsumption of the constraints
+        //
+        // - count:      sized ranges answer in O(1)
+        // - countValue: contiguous ranges of integral values are scanned
+        //               branch-free over a raw pointer, 32-bit values with
+        //               SSE2 / AVX2 (as in StringView_Scanning.cpp)
+        // - find:       contiguous ranges of bytes use std::memchr
+        // - copy:       contiguous, trivially copyable ranges use std::memcpy
+        //
+        // everything else: the generic loop, element by element
+        //
+        // The dispatch must not change the result: countValue and find compare
+        // with one converted value, so they take the fast path for integral
+        // values only (see searchedValue)
+
+        template <typename R>
+        concept ContiguousTrivialRange =
+            std::ranges::contiguous_range<R> &&
+            std::ranges::sized_range<R> &&
+            std::is_trivially_copyable_v<std::ranges::range_value_t<R>>;
+
+        // equality of the values == equality of the bits
+        template <typename R>
+        concept ContiguousIntegralRange =
+            ContiguousTrivialRange<R> && std::integral<std::ranges::range_value_t<R>>;
+
+        template <typename R>
+        concept ContiguousByteRange =
+            ContiguousIntegralRange<R> && sizeof(std::ranges::range_value_t<R>) == 1;
+
+        // ---------------------------------------------------------------
+        // the only element value, that can compare equal to value
+        // (elem == value, as in the generic loop), is static_cast<Value>(value) -
+        // if even this one doesn't, nothing matches: 256 in a range of
+        // std::uint8_t, 0x15A in a std::string
+
+        template <std::integral Value, std::integral T>
+        constexpr std::optional<Value> searchedValue(const T& value)
+        {
+            // the usual arithmetic conversions of elem == value
+            using Common = std::common_type_t<Value, T>;
+
+            const Value searched{ static_cast<Value>(value) };
+
+            if (static_cast<Common>(searched) == static_cast<Common>(value)) {
+                return searched;
+            }
+            return std::nullopt;
+        }
+
+        static_assert(searchedValue<std::uint8_t>(255) == std::uint8_t{ 255 });
+        static_assert(!searchedValue<std::uint8_t>(256).has_value());
+        static_assert(!searchedValue<char>(0x15A).has_value());
+        static_assert(searchedValue<int>(4294967295u) == -1);     // -1 == 4294967295u, too
+
+        // ---------------------------------------------------------------
+        // SIMD kernels: number of 32-bit values equal to value,
+        // one comparison per 4 / 8 values, the matches are counted with popcount
+
+#if defined(CONCEPTS_EXERCISE_SSE2)
+
+        template <std::integral Value>
+            requires (sizeof(Value) == 4)
+        std::size_t countEqualSSE2(const Value* data, std::size_t size, Value value)
+        {
+            const __m128i searched{ _mm_set1_epi32(static_cast<int>(value)) };
+
+            std::size_t count{};
+            std::size_t i{};
+
+            for (; i + 4 <= size; i += 4) {
+                const __m128i chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)) };
+                const int bits{ _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(chunk, searched))) };
+                count += static_cast<std::size_t>(std::popcount(static_cast<unsigned int>(bits)));
+            }
+
+            for (; i != size; ++i) {
+                count += (data[i] == value);
+            }
+
+            return count;
+        }
+
+#endif
+
+#if defined(CONCEPTS_EXERCISE_AVX2)
+
+        template <std::integral Value>
+            requires (sizeof(Value) == 4)
+        std::size_t countEqualAVX2(const Value* data, std::size_t size, Value value)
+        {
+            const __m256i searched{ _mm256_set1_epi32(static_cast<int>(value)) };
+
+            std::size_t count{};
+            std::size_t i{};
+
+            for (; i + 8 <= size; i += 8) {
+                const __m256i chunk{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)) };
+                const int bits{ _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(chunk, searched))) };
+                count += static_cast<std::size_t>(std::popcount(static_cast<unsigned int>(bits)));
+            }
+
+            return count + countEqualSSE2(data + i, size - i, value);
+        }
+
+#endif
+
+        // ---------------------------------------------------------------
+        // count
+
+        template <std::ranges::input_range R>
+        std::size_t count(R&& range)
+        {
+            std::size_t count{};
+            for (auto it{ std::ranges::begin(range) }; it != std::ranges::end(range); ++it) {
+                ++count;
+            }
+            return count;
+        }
+
+        template <std::ranges::input_range R>
+            requires std::ranges::sized_range<R>
+        std::size_t count(R&& range)
+        {
+            return static_cast<std::size_t>(std::ranges::size(range));
+        }
+
+        // ---------------------------------------------------------------
+        // countValue
+
+        template <std::ranges::input_range R, typename T>
+        std::size_t countValue(R&& range, const T& value)
+        {
+            std::size_t count{};
+            for (const auto& elem : range) {
+                if (elem == value) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        template <ContiguousIntegralRange R, std::integral T>
+        std::size_t countValue(R&& range, const T& value)
+        {
+            using Value = std::ranges::range_value_t<R>;
+
+            const auto searchedOrNone{ searchedValue<Value>(value) };
+            if (!searchedOrNone.has_value()) {
+                return 0;
+            }
+
+            const Value* data{ std::ranges::data(range) };
+            const std::size_t size{ std::ranges::size(range) };
+            const Value searched{ *searchedOrNone };
+
+            if constexpr (sizeof(Value) == 4) {
+#if defined(CONCEPTS_EXERCISE_AVX2)
+                return countEqualAVX2(data, size, searched);
+#elif defined(CONCEPTS_EXERCISE_SSE2)
+                return countEqualSSE2(data, size, searched);
+#endif
+            }
+
+            // scalar fallback, branch-free
+            std::size_t count{};
+            for (std::size_t i{}; i != size; ++i) {
+                count += (data[i] == searched);
+            }
+            return count;
+        }
+
+        // ---------------------------------------------------------------
+        // find
+
+        template <std::ranges::input_range R, typename T>
+        auto find(R&& range, const T& value)
+        {
+            auto it{ std::ranges::begin(range) };
+            for (; it != std::ranges::end(range); ++it) {
+                if (*it == value) {
+                    break;
+                }
+            }
+            return it;
+        }
+
+        template <ContiguousByteRange R, std::integral T>
+        auto find(R&& range, const T& value)
+        {
+            const auto searched{ searchedValue<std::ranges::range_value_t<R>>(value) };
+            if (!searched.has_value()) {
+                return std::ranges::begin(range) + static_cast<std::ranges::range_difference_t<R>>(std::ranges::size(range));
+            }
+
+            const auto* data{ std::ranges::data(range) };
+            const std::size_t size{ std::ranges::size(range) };
+
+            const void* pos{ std::memchr(data, static_cast<unsigned char>(*searched), size) };
+            const std::size_t index{ pos == nullptr ? size : static_cast<std::size_t>(static_cast<const unsigned char*>(pos) - reinterpret_cast<const unsigned char*>(data)) };
+
+            return std::ranges::begin(range) + static_cast<std::ranges::range_difference_t<R>>(index);
+        }
+
+        // ---------------------------------------------------------------
+        // copy
+
+        template <std::ranges::input_range R, std::weakly_incrementable TOut>
+            requires std::indirectly_copyable<std::ranges::iterator_t<R>, TOut>
+        TOut copy(R&& range, TOut out)
+        {
+            for (auto it{ std::ranges::begin(range) }; it != std::ranges::end(range); ++it) {
+                *out = *it;
+                ++out;
+            }
+            return out;
+        }
+
+        template <ContiguousTrivialRange R, std::contiguous_iterator TOut>
+            requires std::indirectly_copyable<std::ranges::iterator_t<R>, TOut> &&
+                     std::same_as<std::iter_value_t<TOut>, std::ranges::range_value_t<R>>
+        TOut copy(R&& range, TOut out)
+        {
+            const std::size_t size{ std::ranges::size(range) };
+
+            if (size != 0) {
+                std::memcpy(std::to_address(out), std::ranges::data(range), size * sizeof(std::ranges::range_value_t<R>));
+            }
+
+            return out + static_cast<std::iter_difference_t<TOut>>(size);
+        }
+
+        // ---------------------------------------------------------------
+        // the iterable types of Exercise_03, holding a std::vector<int>
+
+        class VirtualIterableVector : public Exercise_03::Exercise_03_Using_Interface::IntegerIterable
+        {
+        private:
+            const std::vector<int>& m_array;
+            std::size_t             m_index;
+
+        public:
+            VirtualIterableVector(const std::vector<int>& numbers)
+                : m_array{ numbers }, m_index{}
+            {}
+
+            void reset() override { m_index = 0; }
+            bool hasNext() const override { return m_index < m_array.size(); }
+            int next() override { return m_array[m_index++]; }
+        };
+
+        class IterableVector
+        {
+        private:
+            const std::vector<int>& m_array;
+            std::size_t             m_index;
+
+        public:
+            IterableVector(const std::vector<int>& numbers)
+                : m_array{ numbers }, m_index{}
+            {}
+
+            void reset() { m_index = 0; }
+            bool hasNext() const { return m_index < m_array.size(); }
+            int next() { return m_array[m_index++]; }
+        };
+
+        static_assert(Exercise_03::Exercise_03_Using_Concepts::IsIterable<IterableVector>);
+
+        static std::size_t countValueVirtual(Exercise_03::Exercise_03_Using_Interface::IntegerIterable& iterable, int value)
+        {
+            std::size_t count{};
+            iterable.reset();
+            while (iterable.hasNext()) {
+                if (iterable.next() == value) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        template <typename T>
+            requires Exercise_03::Exercise_03_Using_Concepts::IsIterable<T>
+        std::size_t countValueIterable(T& iterable, int value)
+        {
+            std::size_t count{};
+            iterable.reset();
+            while (iterable.hasNext()) {
+                if (iterable.next() == value) {
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        static void testExercise_01()
+        {
+            std::vector<int> numbers{ 1, 2, 3, 2, 1 };
+            std::list<int> list{ 1, 2, 3 };
+            auto odd{ numbers | std::views::filter([](int n) { return n % 2 == 1; }) };
+
+            std::println("count:      {} - {} - {}", count(numbers), count(list), count(odd));
+            std::println("countValue: {} - {} - {}", countValue(numbers, 2), countValue(list, 2), countValue(odd, 1));
+
+            std::string text{ "Hello Concepts" };
+            auto pos{ find(text, 'C') };
+            std::println("find:       {}", std::string_view{ pos, text.end() });
+
+            std::vector<int> target(numbers.size());
+            copy(numbers, target.begin());
+            copy(list, target.begin());
+            std::println("copy:       {}", target);
+
+            // the fast paths return the same results as the generic loop
+            std::vector<std::uint8_t> bytes{ 0, 1, 2, 255 };
+            auto genericNumbers{ numbers | std::views::take_while([](int) { return true; }) };
+            auto genericBytes{ bytes | std::views::take_while([](std::uint8_t) { return true; }) };
+            auto genericText{ text | std::views::take_while([](char) { return true; }) };
+
+            std::println("countValue(numbers, 2.5): {} - generic: {}", countValue(numbers, 2.5), countValue(genericNumbers, 2.5));
+            std::println("countValue(bytes, 256):   {} - generic: {}", countValue(bytes, 256), countValue(genericBytes, 256));
+            std::println("countValue(bytes, 255):   {} - generic: {}", countValue(bytes, 255), countValue(genericBytes, 255));
+            std::println("find(text, 0x16F) found:  {} - generic: {}",
+                find(text, 0x16F) != text.end(), find(genericText, 0x16F) != std::ranges::end(genericText));
+        }
+
+        // ---------------------------------------------------------------
+        // benchmark: virtual interface - concepts (Exercise_03) - dispatched
+
+#ifdef _DEBUG
+        static constexpr std::size_t NumElements = 1'000'000;       // debug
+#else
+        static constexpr std::size_t NumElements = 10'000'000;      // release
+#endif
+
+        static constexpr std::size_t Repetitions{ 10 };
+
+        template <typename TFunc>
+        static void measure(std::string_view label, TFunc func)
+        {
+            std::size_t result{};
+
+            const auto start{ std::chrono::steady_clock::now() };
+            for (std::size_t n{}; n != Repetitions; ++n) {
+                result += func();
+            }
+            const auto end{ std::chrono::steady_clock::now() };
+
+            const std::chrono::duration<double, std::milli> elapsed{ end - start };
+            std::println("  {:<44}{:9.3f} ms  (result {})", label, elapsed.count() / Repetitions, result / Repetitions);
+        }
+
+        static void testExercise_02()
+        {
+            std::vector<int> numbers(NumElements);
+            std::mt19937 engine{ 42 };
+            std::generate(numbers.begin(), numbers.end(), [&] { return static_cast<int>(engine() % 100); });
+
+            // not sized, not contiguous: always the generic loop
+            auto generic{ numbers | std::views::take_while([](int) { return true; }) };
+
+            VirtualIterableVector virtualIterable{ numbers };
+            IterableVector iterable{ numbers };
+
+            std::println("count - {} elements:", NumElements);
+
+            measure("virtual interface (IntegerIterable):", [&] {
+                return static_cast<std::size_t>(Exercise_03::Exercise_03_Using_Interface::count(virtualIterable));
+            });
+            measure("concepts (IsIterable):", [&] {
+                return static_cast<std::size_t>(Exercise_03::Exercise_03_Using_Concepts::count(iterable));
+            });
+            measure("dispatched - generic loop:", [&] { return count(generic); });
+            measure("dispatched - sized range:", [&] { return count(numbers); });
+
+            std::println("countValue:");
+
+            measure("virtual interface (IntegerIterable):", [&] { return countValueVirtual(virtualIterable, 42); });
+            measure("concepts (IsIterable):", [&] { return countValueIterable(iterable, 42); });
+            measure("dispatched - generic loop:", [&] { return countValue(generic, 42); });
+            measure("dispatched - contiguous integral range:", [&] { return countValue(numbers, 42); });
+
+            std::println("find (bytes, value at the end):");
+
+            std::string bytes(NumElements, 'A');
+            bytes.back() = 'Z';
+            auto genericBytes{ bytes | std::views::take_while([](char) { return true; }) };
+
+            measure("dispatched - generic loop:", [&] {
+                return static_cast<std::size_t>(std::ranges::distance(genericBytes.begin(), find(genericBytes, 'Z')));
+            });
+            measure("dispatched - std::memchr:", [&] {
+                return static_cast<std::size_t>(find(bytes, 'Z') - bytes.begin());
+            });
+
+            std::println("copy:");
+
+            std::vector<int> target(NumElements);
+
+            measure("dispatched - generic loop:", [&] {
+                copy(generic, target.begin());
+                return static_cast<std::size_t>(target.back());
+            });
+            measure("dispatched - std::memcpy:", [&] {
+                copy(numbers, target.begin());
+                return static_cast<std::size_t>(target.back());
+            });
+        }
+
+        static void testExercise() {
+            testExercise_01();
+            testExercise_02();
+        }
+    }
+
 }
 
 void test_exercises_concepts()
@@ -590,6 +1019,7 @@ void test_exercises_concepts()
     Exercise_02::testExercise();
     Exercise_03::testExercise();
     Exercise_04::testExercise();
+    Exercise_05::testExercise();
 }
 
 // =====================================================================================
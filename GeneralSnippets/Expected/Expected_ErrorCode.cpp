@@ -0,0 +1,426 @@
+// =====================================================================================
+// Expected_ErrorCode.cpp // std::expected with a compact error type
+// =====================================================================================
+
+module modern_cpp:expected;
+
+import std;
+
+namespace StdExpectedErrorCode {
+
+    // =================================================================================
+    // Expected.cpp uses std::expected<double, std::string>: every error creates
+    // a std::string, the message usually needs a heap allocation.
+    //
+    // Error: error code + message with static storage duration + optional context
+    // (e.g. a position in the input) - 16 bytes, trivially copyable, no allocation.
+    // =================================================================================
+
+    enum class Errc : std::uint8_t
+    {
+        None,
+        EmptyInput,
+        InvalidCharacter,
+        Overflow,
+        OutOfRange,
+        DivisionByZero
+    };
+
+    class Error
+    {
+    private:
+        const char*   m_message;    // string literal
+        std::uint32_t m_context;
+        Errc          m_code;
+
+    public:
+        constexpr Error(Errc code, const char* message, std::uint32_t context = 0) noexcept
+            : m_message{ message }, m_context{ context }, m_code{ code }
+        {}
+
+        constexpr Errc code() const noexcept { return m_code; }
+        constexpr std::string_view message() const noexcept { return m_message; }
+        constexpr std::uint32_t context() const noexcept { return m_context; }
+
+        // same error, additional context
+        constexpr Error withContext(std::uint32_t context) const noexcept {
+            return { m_code, m_message, context };
+        }
+
+        std::string toString() const {
+            return std::format("{} (Code {}, Context {})", m_message, std::to_underlying(m_code), m_context);
+        }
+    };
+
+    static_assert(sizeof(Error) == 16);
+    static_assert(std::is_trivially_copyable_v<Error>);
+
+    template <typename T>
+    using Result = std::expected<T, Error>;
+
+    // =================================================================================
+    // monadic helpers
+    //
+    // Same semantics as the member functions of std::expected, but the branch
+    // into the error path is marked as unlikely: the success path stays a short,
+    // straight sequence which the compiler inlines into the caller.
+    // Passing an error on copies 16 bytes.
+    // =================================================================================
+
+    template <typename T, typename TFunc>
+    constexpr auto andThen(const Result<T>& result, TFunc&& func)
+        -> std::invoke_result_t<TFunc, const T&>
+    {
+        if (result.has_value()) [[likely]] {
+            return std::invoke(std::forward<TFunc>(func), *result);
+        }
+
+        return std::unexpected{ result.error() };
+    }
+
+    template <typename T, typename TFunc>
+    constexpr auto transform(const Result<T>& result, TFunc&& func)
+        -> Result<std::invoke_result_t<TFunc, const T&>>
+    {
+        if (result.has_value()) [[likely]] {
+            return std::invoke(std::forward<TFunc>(func), *result);
+        }
+
+        return std::unexpected{ result.error() };
+    }
+
+    template <typename T, typename TFunc>
+    constexpr Result<T> orElse(const Result<T>& result, TFunc&& func)
+    {
+        if (result.has_value()) [[likely]] {
+            return result;
+        }
+
+        return std::invoke(std::forward<TFunc>(func), result.error());
+    }
+
+    // =================================================================================
+    // divide from Expected.cpp with the compact error type
+    // =================================================================================
+
+    static Result<double> divide(double numerator, double denominator) {
+
+        if (denominator == 0.0) {
+            return std::unexpected{ Error{ Errc::DivisionByZero, "Division by zero" } };
+        }
+
+        return numerator / denominator;
+    }
+
+    static Result<double> addFive(double value) {
+        return value + 5;
+    }
+
+    static void test_01()
+    {
+        auto result{ divide(10.0, 2.5) };
+        std::println("10 / 2.5 = {}", *result);
+
+        result = divide(10.0, 0.0);
+        if (!result.has_value()) {
+            std::println("Error: {}", result.error().toString());
+        }
+
+        // chaining
+        auto chained{ transform(andThen(divide(20.0, 4.0), addFive), [](double value) { return value * 2; }) };
+        std::println("(20 / 4 + 5) * 2 = {}", *chained);
+
+        // error handling with a default value
+        auto recovered{ orElse(andThen(divide(20.0, 0.0), addFive), [](const Error& error) -> Result<double> {
+            std::println("Error occurred: {}", error.message());
+            return 0.0;
+        }) };
+        std::println("Result: {}", *recovered);
+
+        std::println("sizeof(Result<int>):                          {}", sizeof(Result<int>));
+        std::println("sizeof(std::expected<int, std::string>):      {}", sizeof(std::expected<int, std::string>));
+    }
+
+    // =================================================================================
+    // benchmark: parsing numbers with different strategies of error handling
+    //
+    // Each token is parsed, range checked and scaled - the error path is taken
+    // for a configurable fraction of invalid tokens.
+    // =================================================================================
+
+    static constexpr int MaxValue{ 1'000'000 };
+
+    static constexpr Error ErrorEmpty{ Errc::EmptyInput, "Empty input" };
+    static constexpr Error ErrorCharacter{ Errc::InvalidCharacter, "Invalid character" };
+    static constexpr Error ErrorOverflow{ Errc::Overflow, "Number too large" };
+    static constexpr Error ErrorRange{ Errc::OutOfRange, "Value out of range" };
+
+    // ---------------------------------------------------------------------------------
+    // return codes
+
+    static Errc parseReturnCode(std::string_view token, int& result, std::uint32_t& position)
+    {
+        if (token.empty()) {
+            return Errc::EmptyInput;
+        }
+
+        const auto [ptr, ec] { std::from_chars(token.data(), token.data() + token.size(), result) };
+
+        if (ec == std::errc::result_out_of_range) {
+            return Errc::Overflow;
+        }
+
+        if (ec != std::errc{} || ptr != token.data() + token.size()) {
+            position = static_cast<std::uint32_t>(ptr - token.data());
+            return Errc::InvalidCharacter;
+        }
+
+        return Errc::None;
+    }
+
+    static Errc checkRangeReturnCode(int value) {
+        return (value >= 0 && value <= MaxValue) ? Errc::None : Errc::OutOfRange;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // exceptions
+
+    static int parseException(std::string_view token)
+    {
+        if (token.empty()) {
+            throw std::invalid_argument{ "Empty input" };
+        }
+
+        int result{};
+        const auto [ptr, ec] { std::from_chars(token.data(), token.data() + token.size(), result) };
+
+        if (ec == std::errc::result_out_of_range) {
+            throw std::out_of_range{ "Number too large" };
+        }
+
+        if (ec != std::errc{} || ptr != token.data() + token.size()) {
+            throw std::invalid_argument{ "Invalid character" };
+        }
+
+        return result;
+    }
+
+    static int checkRangeException(int value)
+    {
+        if (value < 0 || value > MaxValue) {
+            throw std::out_of_range{ "Value out of range" };
+        }
+
+        return value;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // std::expected<int, std::string> - as in Expected.cpp
+
+    static std::expected<int, std::string> parseString(std::string_view token)
+    {
+        if (token.empty()) {
+            return std::unexpected{ std::string{ "Error: Empty input" } };
+        }
+
+        int result{};
+        const auto [ptr, ec] { std::from_chars(token.data(), token.data() + token.size(), result) };
+
+        if (ec == std::errc::result_out_of_range) {
+            return std::unexpected{ std::string{ "Error: Number too large" } };
+        }
+
+        if (ec != std::errc{} || ptr != token.data() + token.size()) {
+            return std::unexpected{ std::format("Error: Invalid character at position {}", ptr - token.data()) };
+        }
+
+        return result;
+    }
+
+    static std::expected<int, std::string> checkRangeString(int value)
+    {
+        if (value < 0 || value > MaxValue) {
+            return std::unexpected{ std::string{ "Error: Value out of range" } };
+        }
+
+        return value;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // std::expected<int, Error>
+
+    static Result<int> parseExpected(std::string_view token)
+    {
+        if (token.empty()) [[unlikely]] {
+            return std::unexpected{ ErrorEmpty };
+        }
+
+        int result{};
+        const auto [ptr, ec] { std::from_chars(token.data(), token.data() + token.size(), result) };
+
+        if (ec == std::errc::result_out_of_range) [[unlikely]] {
+            return std::unexpected{ ErrorOverflow };
+        }
+
+        if (ec != std::errc{} || ptr != token.data() + token.size()) [[unlikely]] {
+            return std::unexpected{ ErrorCharacter.withContext(static_cast<std::uint32_t>(ptr - token.data())) };
+        }
+
+        return result;
+    }
+
+    static Result<int> checkRangeExpected(int value)
+    {
+        if (value < 0 || value > MaxValue) [[unlikely]] {
+            return std::unexpected{ ErrorRange };
+        }
+
+        return value;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // test data
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumTokens = 100'000;        // debug
+    static constexpr std::size_t Repetitions = 3;
+#else
+    static constexpr std::size_t NumTokens = 1'000'000;      // release
+    static constexpr std::size_t Repetitions = 10;
+#endif
+
+    static constexpr std::array<double, 4> ErrorRates{ 0.0, 0.001, 0.01, 0.1 };
+
+    // valid numbers, errorRate of the tokens is invalid (all kinds of errors)
+    static std::vector<std::string> createTokens(double errorRate)
+    {
+        std::mt19937 engine{ 42 };
+        std::uniform_int_distribution<int> values{ 0, MaxValue };
+        std::bernoulli_distribution isError{ errorRate };
+
+        std::vector<std::string> tokens{};
+        tokens.reserve(NumTokens);
+
+        for (std::size_t i{}; i != NumTokens; ++i) {
+
+            if (isError(engine)) {
+                switch (i % 4)
+                {
+                case 0:  tokens.push_back(""); break;
+                case 1:  tokens.push_back(std::format("{}x", values(engine))); break;
+                case 2:  tokens.push_back("99999999999"); break;
+                default: tokens.push_back(std::format("{}", MaxValue + 1 + values(engine))); break;
+                }
+            }
+            else {
+                tokens.push_back(std::format("{}", values(engine)));
+            }
+        }
+
+        return tokens;
+    }
+
+    struct Totals
+    {
+        std::int64_t m_sum{};
+        std::size_t  m_errors{};
+    };
+
+    template <typename TParse>
+    static double measure(const std::vector<std::string>& tokens, Totals& totals, TParse parse)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+
+        for (std::size_t n{}; n != Repetitions; ++n) {
+            for (const auto& token : tokens) {
+                parse(token, totals);
+            }
+        }
+
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double, std::nano> elapsed{ end - start };
+        return elapsed.count() / static_cast<double>(Repetitions * tokens.size());
+    }
+
+    static void test_02()
+    {
+        std::println("ns per token:  {:>8} {:>12} {:>12} {:>12} {:>12}",
+            "Errors", "Return code", "Exception", "expected<s>", "expected<E>");
+
+        for (auto errorRate : ErrorRates) {
+
+            const auto tokens{ createTokens(errorRate) };
+
+            Totals totals[4]{};
+
+            const double nsReturnCode{ measure(tokens, totals[0], [](std::string_view token, Totals& totals) {
+                int value{};
+                std::uint32_t position{};
+                Errc error{ parseReturnCode(token, value, position) };
+                if (error == Errc::None) {
+                    error = checkRangeReturnCode(value);
+                }
+                if (error == Errc::None) {
+                    totals.m_sum += value * 2;
+                }
+                else {
+                    totals.m_errors += std::to_underlying(error) != 0;
+                }
+            }) };
+
+            const double nsException{ measure(tokens, totals[1], [](std::string_view token, Totals& totals) {
+                try {
+                    totals.m_sum += checkRangeException(parseException(token)) * 2;
+                }
+                catch (const std::exception& ex) {
+                    totals.m_errors += ex.what()[0] != '\0';
+                }
+            }) };
+
+            const double nsString{ measure(tokens, totals[2], [](std::string_view token, Totals& totals) {
+                auto result{ parseString(token)
+                    .and_then(checkRangeString)
+                    .transform([](int value) { return value * 2; }) };
+
+                if (result.has_value()) {
+                    totals.m_sum += *result;
+                }
+                else {
+                    totals.m_errors += !result.error().empty();
+                }
+            }) };
+
+            const double nsExpected{ measure(tokens, totals[3], [](std::string_view token, Totals& totals) {
+                auto result{ transform(andThen(parseExpected(token), checkRangeExpected),
+                    [](int value) { return value * 2; }) };
+
+                if (result.has_value()) {
+                    totals.m_sum += *result;
+                }
+                else {
+                    totals.m_errors += result.error().code() != Errc::None;
+                }
+            }) };
+
+            // all strategies must find the same values and errors
+            const bool same{ std::all_of(std::begin(totals), std::end(totals), [&](const Totals& t) {
+                return t.m_sum == totals[0].m_sum && t.m_errors == totals[0].m_errors;
+            }) };
+
+            std::println("{:>22.1f}% {:12.1f} {:12.1f} {:12.1f} {:12.1f}{}",
+                errorRate * 100.0, nsReturnCode, nsException, nsString, nsExpected, same ? "" : "   (results differ!)");
+        }
+    }
+}
+
+void main_expected_error_code()
+{
+    using namespace StdExpectedErrorCode;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,7 @@
 export module modern_cpp:expected;
 
 export void main_expected();
+export void main_expected_error_code();
 
 // =====================================================================================
 // End-of-File
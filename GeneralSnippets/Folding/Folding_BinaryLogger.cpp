@@ -0,0 +1,602 @@
+// =====================================================================================
+// Folding_BinaryLogger.cpp // Variadic Templates // Logging with deferred formatting
+// =====================================================================================
+
+module modern_cpp:folding;
+
+import std;
+
+namespace FoldingBinaryLogger {
+
+    // =================================================================================
+    // createDelayedPrinter in Folding.cpp captures a parameter pack and formats
+    // later - the principle of a low-latency logger. Here the calling thread
+    // neither allocates nor formats:
+    //
+    // - the arguments are serialized into a per-thread queue (SPSC ring buffer):
+    //   trivially copyable arguments by memcpy, strings as length + characters
+    // - each call site owns a format string ID, registered once, together with
+    //   a function decoding exactly the types of this call site
+    // - a backend thread decodes the records, formats them and writes them
+    //   into a sink
+    //
+    // Record layout: RecordHeader | timestamp | argument 1 | argument 2 | ...
+    // =================================================================================
+
+    static constexpr std::size_t CacheLineSize{ 64 };
+    static constexpr std::size_t RecordAlignment{ 8 };
+
+    struct RecordHeader
+    {
+        std::uint32_t m_size;        // complete record, multiple of RecordAlignment
+        std::uint32_t m_formatId;
+    };
+
+    static_assert(sizeof(RecordHeader) == RecordAlignment);
+
+    constexpr std::size_t alignRecord(std::size_t size) noexcept {
+        return (size + RecordAlignment - 1) & ~(RecordAlignment - 1);
+    }
+
+    // =================================================================================
+    // SpscQueue: ring buffer of variable-sized records, one producer, one consumer
+    //
+    // Records are contiguous: a record not fitting before the end of the buffer
+    // is preceded by a padding record filling the rest of the buffer.
+    // Producer and consumer positions live on different cache lines,
+    // each side caches the position of the other side.
+    // =================================================================================
+
+    class SpscQueue
+    {
+    public:
+        static constexpr std::uint32_t PaddingId{ 0xFFFF'FFFF };
+
+    private:
+        std::size_t                  m_capacity;
+        std::size_t                  m_mask;
+        std::unique_ptr<std::byte[]> m_buffer;
+        std::thread::id              m_owner;
+
+        alignas(CacheLineSize) std::atomic<std::uint64_t> m_head;     // written by the producer
+        std::uint64_t                                     m_cachedTail;
+
+        alignas(CacheLineSize) std::atomic<std::uint64_t> m_tail;     // written by the consumer
+
+    public:
+        SpscQueue(std::size_t capacity, std::thread::id owner)
+            : m_capacity{ std::bit_ceil(std::max(capacity, std::size_t{ 1024 })) },
+              m_mask{ m_capacity - 1 },
+              m_buffer{ std::make_unique<std::byte[]>(m_capacity) },
+              m_owner{ owner },
+              m_head{},
+              m_cachedTail{},
+              m_tail{}
+        {}
+
+        std::thread::id owner() const noexcept { return m_owner; }
+
+        bool empty() const noexcept {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+        // =============================================================================
+        // producer
+        // =============================================================================
+
+        // size: multiple of RecordAlignment - returns nullptr, if the queue is full
+        std::byte* reserve(std::size_t size) noexcept
+        {
+            const std::uint64_t head{ m_head.load(std::memory_order_relaxed) };
+            const std::size_t index{ static_cast<std::size_t>(head & m_mask) };
+            const std::size_t contiguous{ m_capacity - index };
+            const std::size_t padding{ contiguous < size ? contiguous : 0 };
+
+            if (size + padding > m_capacity - (head - m_cachedTail)) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+                if (size + padding > m_capacity - (head - m_cachedTail)) {
+                    return nullptr;
+                }
+            }
+
+            if (padding != 0) {
+                const RecordHeader header{ static_cast<std::uint32_t>(padding), PaddingId };
+                std::memcpy(m_buffer.get() + index, &header, sizeof(header));
+                m_head.store(head + padding, std::memory_order_release);
+                return m_buffer.get();
+            }
+
+            return m_buffer.get() + index;
+        }
+
+        void commit(std::size_t size) noexcept
+        {
+            m_head.store(m_head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+        }
+
+        // =============================================================================
+        // consumer
+        // =============================================================================
+
+        // calls func(header, payload) for all available records
+        template <typename TFunc>
+        std::size_t consume(TFunc&& func)
+        {
+            std::uint64_t tail{ m_tail.load(std::memory_order_relaxed) };
+            const std::uint64_t head{ m_head.load(std::memory_order_acquire) };
+
+            std::size_t count{};
+
+            while (tail != head) {
+                const std::byte* record{ m_buffer.get() + (tail & m_mask) };
+
+                RecordHeader header{};
+                std::memcpy(&header, record, sizeof(header));
+
+                if (header.m_formatId != PaddingId) {
+                    func(header, record + sizeof(header));
+                    ++count;
+                }
+
+                // space can be reused by the producer
+                tail += header.m_size;
+                m_tail.store(tail, std::memory_order_release);
+            }
+
+            return count;
+        }
+    };
+
+    // =================================================================================
+    // argument encoding
+    // =================================================================================
+
+    template <typename T>
+    concept StringLike = std::convertible_to<const T&, std::string_view>;
+
+    // type of an argument inside a record - strings are decoded as std::string_view
+    // pointing into the record
+    template <typename T>
+    using Stored = std::conditional_t<StringLike<T>, std::string_view, std::remove_cvref_t<T>>;
+
+    template <typename T>
+    static Stored<T> toStored(const T& arg)
+    {
+        if constexpr (StringLike<T>) {
+            return std::string_view{ arg };
+        }
+        else {
+            static_assert(std::is_trivially_copyable_v<T>, "Logger: argument must be trivially copyable or a string");
+            return arg;
+        }
+    }
+
+    template <typename T>
+    static std::size_t encodedSize(const T& value)
+    {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return sizeof(std::uint32_t) + value.size();
+        }
+        else {
+            return sizeof(T);
+        }
+    }
+
+    template <typename T>
+    static std::byte* encode(std::byte* pos, const T& value)
+    {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            const std::uint32_t length{ static_cast<std::uint32_t>(value.size()) };
+            std::memcpy(pos, &length, sizeof(length));
+            std::memcpy(pos + sizeof(length), value.data(), value.size());
+            return pos + sizeof(length) + value.size();
+        }
+        else {
+            std::memcpy(pos, &value, sizeof(T));
+            return pos + sizeof(T);
+        }
+    }
+
+    template <typename T>
+    static T decode(const std::byte*& pos)
+    {
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            std::uint32_t length{};
+            std::memcpy(&length, pos, sizeof(length));
+            const std::string_view value{ reinterpret_cast<const char*>(pos + sizeof(length)), length };
+            pos += sizeof(length) + length;
+            return value;
+        }
+        else {
+            T value{};
+            std::memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+    }
+
+    template <typename... TStored>
+    static std::string decodeAndFormat(std::string_view format, [[maybe_unused]] const std::byte* payload)
+    {
+        // braced initialization: the arguments are decoded from left to right
+        const std::tuple<TStored...> values{ decode<TStored>(payload)... };
+
+        return std::apply(
+            [&](const auto&... args) { return std::vformat(format, std::make_format_args(args...)); },
+            values
+        );
+    }
+
+    // =================================================================================
+    // format strings: a template parameter, and a registry mapping IDs to
+    // format string + decoding function
+    // =================================================================================
+
+    template <std::size_t N>
+    struct FormatString
+    {
+        char m_chars[N];
+
+        constexpr FormatString(const char (&chars)[N]) {
+            std::copy_n(chars, N, m_chars);
+        }
+
+        constexpr std::string_view view() const { return { m_chars, N - 1 }; }
+    };
+
+    class FormatRegistry
+    {
+    public:
+        using Formatter = std::string(*)(std::string_view format, const std::byte* payload);
+
+        static constexpr std::size_t MaxFormats{ 4096 };
+
+    private:
+        struct Entry
+        {
+            std::string_view m_format;
+            Formatter        m_formatter;
+        };
+
+        // fixed size: the backend may read entries while new ones are added
+        std::array<Entry, MaxFormats> m_entries{};
+        std::size_t                   m_count{};
+        std::mutex                    m_mutex{};
+
+        FormatRegistry() = default;
+
+    public:
+        static FormatRegistry& instance() {
+            static FormatRegistry registry{};
+            return registry;
+        }
+
+        std::uint32_t add(std::string_view format, Formatter formatter)
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+
+            if (m_count == MaxFormats) {
+                throw std::length_error{ "FormatRegistry: too many format strings" };
+            }
+
+            m_entries[m_count] = { format, formatter };
+            return static_cast<std::uint32_t>(m_count++);
+        }
+
+        // no lock: a record with this id was published after the registration
+        std::string format(std::uint32_t id, const std::byte* payload) const {
+            return m_entries[id].m_formatter(m_entries[id].m_format, payload);
+        }
+    };
+
+    // one ID per call site (format string and argument types),
+    // registered at the first call
+    template <FormatString Format, typename... TStored>
+    static std::uint32_t formatId()
+    {
+        static const std::uint32_t id{ FormatRegistry::instance().add(Format.view(), &decodeAndFormat<TStored...>) };
+        return id;
+    }
+
+    // =================================================================================
+    // Logger
+    // =================================================================================
+
+    class Logger
+    {
+    public:
+        using Sink = std::function<void(std::string_view)>;
+
+    private:
+        inline static std::atomic<std::uint64_t> s_nextId{ 1 };
+
+        std::uint64_t                           m_id;
+        std::size_t                             m_queueCapacity;
+        Sink                                    m_sink;
+        std::chrono::steady_clock::time_point   m_start;
+
+        mutable std::mutex                      m_mutex;      // protects m_queues
+        std::vector<std::unique_ptr<SpscQueue>> m_queues;
+        std::atomic<std::size_t>                m_dropped;
+
+        std::jthread                            m_backend;
+
+    public:
+        explicit Logger(Sink sink, std::size_t queueCapacity = 1 << 20)
+            : m_id{ s_nextId++ },
+              m_queueCapacity{ queueCapacity },
+              m_sink{ std::move(sink) },
+              m_start{ std::chrono::steady_clock::now() },
+              m_mutex{},
+              m_queues{},
+              m_dropped{},
+              m_backend{ [this](std::stop_token token) { run(token); } }
+        {}
+
+        ~Logger()
+        {
+            m_backend.request_stop();
+            m_backend.join();   // the backend writes all pending records
+        }
+
+        // no copying or moving
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        Logger(Logger&&) noexcept = delete;
+        Logger& operator=(Logger&&) noexcept = delete;
+
+        // hot path: returns false, if the queue of this thread is full (record dropped)
+        template <FormatString Format, typename... TArgs>
+        bool log(const TArgs&... args)
+        {
+            // compile-time check of the format string against the argument types
+            [[maybe_unused]] static constexpr std::format_string<const Stored<TArgs>&...> checked{ Format.view() };
+
+            const std::uint32_t id{ formatId<Format, Stored<TArgs>...>() };
+            const std::int64_t timestamp{ std::chrono::steady_clock::now().time_since_epoch().count() };
+
+            return write(id, timestamp, toStored(args)...);
+        }
+
+        // waits until all records logged so far have been written to the sink
+        void flush() const
+        {
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> guard{ m_mutex };
+                    if (std::ranges::all_of(m_queues, [](const auto& queue) { return queue->empty(); })) {
+                        return;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        std::size_t dropped() const noexcept { return m_dropped.load(); }
+
+    private:
+        template <typename... TStored>
+        bool write(std::uint32_t id, std::int64_t timestamp, const TStored&... values)
+        {
+            const std::size_t size{
+                alignRecord(sizeof(RecordHeader) + sizeof(timestamp) + (std::size_t{} + ... + encodedSize(values)))
+            };
+
+            SpscQueue& queue{ localQueue() };
+
+            std::byte* pos{ queue.reserve(size) };
+            if (pos == nullptr) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            const RecordHeader header{ static_cast<std::uint32_t>(size), id };
+            pos = encode(pos, header);
+            pos = encode(pos, timestamp);
+            ((pos = encode(pos, values)), ...);
+
+            queue.commit(size);
+            return true;
+        }
+
+        // the queue of the calling thread, created at its first log call
+        SpscQueue& localQueue()
+        {
+            thread_local std::uint64_t t_logger{};
+            thread_local SpscQueue*    t_queue{};
+
+            if (t_logger != m_id) {
+                t_queue = &queueOfThread(std::this_thread::get_id());
+                t_logger = m_id;
+            }
+
+            return *t_queue;
+        }
+
+        SpscQueue& queueOfThread(std::thread::id thread)
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+
+            auto pos{ std::ranges::find(m_queues, thread, [](const auto& queue) { return queue->owner(); }) };
+            if (pos != m_queues.end()) {
+                return **pos;
+            }
+
+            return *m_queues.emplace_back(std::make_unique<SpscQueue>(m_queueCapacity, thread));
+        }
+
+        // =============================================================================
+        // backend
+        // =============================================================================
+
+        void run(std::stop_token token)
+        {
+            std::vector<SpscQueue*> queues{};
+
+            while (!token.stop_requested()) {
+                if (drain(queues) == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+                }
+            }
+
+            drain(queues);
+        }
+
+        std::size_t drain(std::vector<SpscQueue*>& queues)
+        {
+            {
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                queues.clear();
+                for (const auto& queue : m_queues) {
+                    queues.push_back(queue.get());
+                }
+            }
+
+            std::size_t count{};
+
+            for (SpscQueue* queue : queues) {
+                count += queue->consume([&](const RecordHeader& header, const std::byte* payload) {
+
+                    const std::int64_t timestamp{ decode<std::int64_t>(payload) };
+
+                    const std::chrono::steady_clock::duration time{ timestamp };
+                    const std::chrono::duration<double, std::micro> elapsed{ time - m_start.time_since_epoch() };
+
+                    m_sink(std::format("[{:12.3f} us] {}", elapsed.count(),
+                        FormatRegistry::instance().format(header.m_formatId, payload)));
+                });
+            }
+
+            return count;
+        }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        Logger logger{ [](std::string_view line) { std::println("{}", line); } };
+
+        const std::string name{ "Sepp" };
+
+        logger.log<"Hello - Variadic - Capture!">();
+        logger.log<"Name: {}, Age: {}">(name, 40);
+        logger.log<"Price: {:.2f} - Quantity: {} - Open: {}">(123.456, 17u, true);
+        logger.log<"C-String: {} - Character: {}">("ABC", 'x');
+
+        {
+            std::jthread worker{ [&] {
+                for (int i{}; i != 3; ++i) {
+                    logger.log<"Worker thread: message {}">(i);
+                }
+            } };
+        }
+
+        // would not compile: format string needs two arguments
+        // logger.log<"{} {}">(1);
+
+        logger.flush();
+        std::println("Dropped: {}", logger.dropped());
+    }
+
+    // =================================================================================
+    // benchmark: latency of a log call in the calling thread
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumMessages = 100'000;       // debug
+#else
+    static constexpr std::size_t NumMessages = 1'000'000;     // release
+#endif
+
+    static constexpr std::size_t BatchSize{ 100 };   // calls per time measurement
+
+    // calls 'call' NumMessages times, measured in batches - statistics per call
+    template <typename TCall>
+    static void measureLatency(std::string_view label, TCall call)
+    {
+        std::vector<double> latencies{};
+        latencies.reserve(NumMessages / BatchSize);
+
+        for (std::size_t batch{}; batch != NumMessages / BatchSize; ++batch) {
+
+            const auto start{ std::chrono::steady_clock::now() };
+            for (std::size_t i{}; i != BatchSize; ++i) {
+                call(batch * BatchSize + i);
+            }
+            const auto end{ std::chrono::steady_clock::now() };
+
+            const std::chrono::duration<double, std::nano> elapsed{ end - start };
+            latencies.push_back(elapsed.count() / BatchSize);
+        }
+
+        std::ranges::sort(latencies);
+
+        const double mean{ std::accumulate(latencies.begin(), latencies.end(), 0.0) / static_cast<double>(latencies.size()) };
+
+        std::println("{:<34} mean: {:8.1f} ns - p50: {:8.1f} ns - p99: {:8.1f} ns - max: {:8.1f} ns",
+            label, mean, latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back());
+    }
+
+    static constexpr std::array<std::string_view, 4> Symbols{ "AAPL", "MSFT", "AMZN", "NVDA" };
+
+    static void test_02()
+    {
+        std::size_t characters{};
+
+        // synchronous: formatting in the calling thread
+        measureLatency("std::format (synchronous):", [&](std::size_t i) {
+            const std::string line{ std::format("Order {} filled: {} @ {:.2f} ({})", i, 100 + i % 50, 99.5 + static_cast<double>(i % 100), Symbols[i % 4]) };
+            characters += line.size();
+        });
+
+        // as createDelayedPrinter in Folding.cpp: capture into a lambda, format later
+        {
+            std::vector<std::function<std::string()>> delayed{};
+            delayed.reserve(NumMessages);
+
+            measureLatency("Variadic capture (std::function):", [&](std::size_t i) {
+                delayed.push_back(
+                    [args = std::make_tuple(i, 100 + i % 50, 99.5 + static_cast<double>(i % 100), std::string{ Symbols[i % 4] })] () {
+                        return std::apply([](const auto&... values) {
+                            return std::format("Order {} filled: {} @ {:.2f} ({})", values...);
+                        }, args);
+                    }
+                );
+            });
+
+            for (const auto& printer : delayed) {
+                characters += printer().size();
+            }
+        }
+
+        // binary logger
+        {
+            Logger logger{ [&](std::string_view line) { characters += line.size(); }, std::size_t{ 1 } << 26 };
+
+            measureLatency("Binary logger:", [&](std::size_t i) {
+                logger.log<"Order {} filled: {} @ {:.2f} ({})">(i, 100 + i % 50, 99.5 + static_cast<double>(i % 100), Symbols[i % 4]);
+            });
+
+            logger.flush();
+            std::println("Dropped: {}", logger.dropped());
+        }
+
+        std::println("Characters formatted: {}", characters);
+    }
+}
+
+void main_folding_binary_logger()
+{
+    using namespace FoldingBinaryLogger;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
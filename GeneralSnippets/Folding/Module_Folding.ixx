@@ -5,6 +5,7 @@
 export module modern_cpp:folding;
 
 export void main_folding();
+export void main_folding_binary_logger();
 
 // =====================================================================================
 // End-of-File
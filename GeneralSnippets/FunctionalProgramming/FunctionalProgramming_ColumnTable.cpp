@@ -0,0 +1,461 @@
+// =====================================================================================
+// FunctionalProgramming_ColumnTable.cpp // Filter-Map-Reduce on a columnar table
+// =====================================================================================
+
+module modern_cpp:functional_programming;
+
+import std;
+import scoped_timer;
+
+namespace FunctionalProgramming_ColumnTable {
+
+    // =================================================================================
+    // filter, map and foldLeft as in FunctionalProgramming03.cpp
+    // =================================================================================
+
+    template <typename TContainer, typename TResult, typename TFunctor>
+    TResult foldLeft(TContainer cont, TResult&& init, TFunctor&& lambda)
+    {
+        return std::accumulate(
+            std::begin(cont),
+            std::end(cont),
+            std::move(init),
+            std::forward<TFunctor>(lambda));
+    }
+
+    template <typename TContainer, typename TFunctor>
+    auto filter(TContainer&& cont, TFunctor&& lambda)
+    {
+        using ValueType = typename std::remove_reference<decltype (cont[0])>::type;
+
+        std::vector<ValueType> result;
+        result.reserve(std::distance(std::begin(cont), std::end(cont)));
+        std::copy_if(
+            std::begin(cont),
+            std::end(cont),
+            std::back_inserter(result),
+            std::forward<TFunctor>(lambda)
+        );
+        return result;
+    }
+
+    template <typename TFunctor, typename TContainer>
+    auto map(TContainer cont, TFunctor&& lambda)
+    {
+        std::vector<decltype(std::declval<TFunctor>()(std::declval<typename TContainer::value_type>()))> result;
+
+        std::transform(
+            std::begin(cont),
+            std::end(cont),
+            std::back_inserter(result),
+            std::forward<TFunctor>(lambda));
+
+        return result;
+    }
+
+    // =================================================================================
+    // ColumnTable<&Record::m_field1, &Record::m_field2, ...>
+    //
+    // The record description is the list of its data member pointers:
+    // every member gets its own contiguous column (std::vector), a record is
+    // split into its fields on insertion ("structure of arrays").
+    //
+    // Queries work column-at-a-time:
+    // - select():   one predicate over one column => selection vector (row numbers)
+    // - refine():   further predicates, evaluated for the selected rows only
+    // - sum():      aggregation over a selection or over a whole column
+    // - sumWhere(): fused predicate + aggregation over two columns without
+    //               branches, the compiler can vectorize the loop
+    // =================================================================================
+
+    template <typename T>
+    struct MemberPointerTraits;
+
+    template <typename TRecord, typename TField>
+    struct MemberPointerTraits<TField TRecord::*>
+    {
+        using Record = TRecord;
+        using Field = TField;
+    };
+
+    template <auto Member>
+    using FieldType = typename MemberPointerTraits<decltype(Member)>::Field;
+
+    template <auto First, auto Second>
+    constexpr bool isSameMember()
+    {
+        if constexpr (std::is_same_v<decltype(First), decltype(Second)>) {
+            return First == Second;
+        }
+        else {
+            return false;
+        }
+    }
+
+    using Selection = std::vector<std::uint32_t>;   // row numbers, ascending
+
+    template <auto FirstMember, auto... Members>
+    class ColumnTable
+    {
+    public:
+        using Record = typename MemberPointerTraits<decltype(FirstMember)>::Record;
+
+        static_assert((std::is_same_v<Record, typename MemberPointerTraits<decltype(Members)>::Record> && ...),
+            "ColumnTable: all members must belong to the same record type");
+
+    private:
+        std::tuple<std::vector<FieldType<FirstMember>>, std::vector<FieldType<Members>>...> m_columns;
+        std::size_t m_size;
+
+        template <auto Member>
+        static constexpr std::size_t indexOf()
+        {
+            constexpr std::array<bool, 1 + sizeof...(Members)> matches{
+                isSameMember<Member, FirstMember>(), isSameMember<Member, Members>()...
+            };
+
+            std::size_t index{};
+            while (index != matches.size() && !matches[index]) {
+                ++index;
+            }
+            return index;
+        }
+
+    public:
+        ColumnTable() : m_columns{}, m_size{} {}
+
+        std::size_t size() const noexcept { return m_size; }
+
+        void reserve(std::size_t capacity)
+        {
+            std::apply([=](auto&... columns) { (columns.reserve(capacity), ...); }, m_columns);
+        }
+
+        void push_back(const Record& record)
+        {
+            std::get<0>(m_columns).push_back(record.*FirstMember);
+            pushMembers(record, std::index_sequence_for<decltype(Members)...>{});
+            ++m_size;
+        }
+
+        template <auto Member>
+        std::span<const FieldType<Member>> column() const noexcept
+        {
+            static_assert(indexOf<Member>() != 1 + sizeof...(Members), "ColumnTable: member is not part of the table");
+            return std::get<indexOf<Member>()>(m_columns);
+        }
+
+        // reassembles a record (for the selected rows)
+        Record row(std::size_t index) const
+        {
+            Record record{};
+            record.*FirstMember = std::get<0>(m_columns)[index];
+            readMembers(record, index, std::index_sequence_for<decltype(Members)...>{});
+            return record;
+        }
+
+        // =============================================================================
+        // queries
+        // =============================================================================
+
+        template <auto Member, typename TPredicate>
+        Selection select(TPredicate predicate) const
+        {
+            const auto values{ column<Member>() };
+
+            Selection selection(values.size());
+
+            // branchless: the row number is always written, but only kept,
+            // if the predicate holds - no mispredicted branches
+            std::size_t count{};
+            for (std::size_t i{}; i != values.size(); ++i) {
+                selection[count] = static_cast<std::uint32_t>(i);
+                count += predicate(values[i]) ? 1 : 0;
+            }
+
+            selection.resize(count);
+            return selection;
+        }
+
+        template <auto Member, typename TPredicate>
+        void refine(Selection& selection, TPredicate predicate) const
+        {
+            const auto values{ column<Member>() };
+
+            std::size_t count{};
+            for (std::uint32_t row : selection) {
+                selection[count] = row;
+                count += predicate(values[row]) ? 1 : 0;
+            }
+
+            selection.resize(count);
+        }
+
+        template <auto Member>
+        FieldType<Member> sum(const Selection& selection) const
+        {
+            const auto values{ column<Member>() };
+
+            FieldType<Member> result{};
+            for (std::uint32_t row : selection) {
+                result += values[row];
+            }
+            return result;
+        }
+
+        template <auto Member>
+        FieldType<Member> sum() const
+        {
+            const auto values{ column<Member>() };
+            return sumLanes(values.size(), [&](std::size_t i) { return values[i]; });
+        }
+
+        // sum of column 'Member' over all rows, where 'predicate' holds for column 'FilterMember'
+        template <auto Member, auto FilterMember, typename TPredicate>
+        FieldType<Member> sumWhere(TPredicate predicate) const
+        {
+            const auto values{ column<Member>() };
+            const auto filter{ column<FilterMember>() };
+
+            return sumLanes(values.size(), [&](std::size_t i) {
+                return predicate(filter[i]) ? values[i] : FieldType<Member>{};
+            });
+        }
+
+    private:
+        template <std::size_t... Is>
+        void pushMembers(const Record& record, std::index_sequence<Is...>)
+        {
+            (std::get<Is + 1>(m_columns).push_back(record.*Members), ...);
+        }
+
+        template <std::size_t... Is>
+        void readMembers(Record& record, std::size_t index, std::index_sequence<Is...>) const
+        {
+            ((record.*Members = std::get<Is + 1>(m_columns)[index]), ...);
+        }
+
+        // several independent partial sums: floating point additions are not
+        // associative, a single accumulator would prevent vectorization
+        template <typename TValue>
+        static TValue sumLanesImpl(std::size_t size, auto value)
+        {
+            static constexpr std::size_t Lanes{ 8 };
+
+            std::array<TValue, Lanes> partial{};
+
+            std::size_t i{};
+            for (; i + Lanes <= size; i += Lanes) {
+                for (std::size_t lane{}; lane != Lanes; ++lane) {
+                    partial[lane] += value(i + lane);
+                }
+            }
+
+            TValue result{};
+            for (; i != size; ++i) {
+                result += value(i);
+            }
+
+            return std::accumulate(partial.begin(), partial.end(), result);
+        }
+
+        template <typename TFunc>
+        static auto sumLanes(std::size_t size, TFunc value)
+        {
+            using TValue = std::remove_cvref_t<decltype(value(0))>;
+            return sumLanesImpl<TValue>(size, value);
+        }
+    };
+
+    // =================================================================================
+    // Book (as in FunctionalProgramming03.cpp)
+    // =================================================================================
+
+    class Book {
+    public:
+        std::string m_title;
+        std::string m_author;
+        int m_year;
+        double m_price;
+    };
+
+    using BookTable = ColumnTable<&Book::m_title, &Book::m_author, &Book::m_year, &Book::m_price>;
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        std::vector<Book> booksList{
+            {"C", "Dennis Ritchie", 1972, 11.99 } ,
+            {"Java", "James Gosling", 1995, 19.99 },
+            {"C++", "Bjarne Stroustrup", 1985, 20.00 },
+            {"C#", "Anders Hejlsberg", 2000, 29.99 }
+        };
+
+        BookTable books{};
+        for (const auto& book : booksList) {
+            books.push_back(book);
+        }
+
+        // a) filter books which appeared past 1990
+        // b) extract book title and authors name
+        // c) reduce to result string, e.g. comma separated list
+
+        Selection selection{ books.select<&Book::m_year>([](int year) { return year >= 1990; }) };
+
+        const auto titles{ books.column<&Book::m_title>() };
+        const auto authors{ books.column<&Book::m_author>() };
+
+        std::string result{};
+        for (std::uint32_t row : selection) {
+            result += std::format("{}{} [{}]", result.empty() ? "" : " | ", titles[row], authors[row]);
+        }
+        std::println("{}", result);
+
+        // aggregations
+        std::println("Sum of prices (all books):   {:.2f}", books.sum<&Book::m_price>());
+        std::println("Sum of prices (since 1990):  {:.2f}", books.sum<&Book::m_price>(selection));
+        std::println("Sum of prices (since 1990):  {:.2f}",
+            books.sumWhere<&Book::m_price, &Book::m_year>([](int year) { return year >= 1990; }));
+
+        books.refine<&Book::m_price>(selection, [](double price) { return price < 25.0; });
+        for (std::uint32_t row : selection) {
+            Book book{ books.row(row) };
+            std::println("Since 1990, less than 25.00: {} ({}, {:.2f})", book.m_title, book.m_year, book.m_price);
+        }
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumBooks = 200'000;        // debug
+#else
+    static constexpr std::size_t NumBooks = 2'000'000;      // release
+#endif
+
+    static std::vector<Book> makeCatalog()
+    {
+        static constexpr std::array<std::string_view, 4> Authors{
+            "Dennis Ritchie", "James Gosling", "Bjarne Stroustrup", "Anders Hejlsberg"
+        };
+
+        std::mt19937 engine{ 42 };
+        std::uniform_int_distribution<int> years{ 1950, 2024 };
+        std::uniform_int_distribution<int> cents{ 500, 9999 };
+
+        std::vector<Book> catalog{};
+        catalog.reserve(NumBooks);
+
+        for (std::size_t i{}; i != NumBooks; ++i) {
+            catalog.push_back(Book{
+                std::format("Title {}", i),
+                std::string{ Authors[i % Authors.size()] },
+                years(engine),
+                cents(engine) / 100.0
+            });
+        }
+
+        return catalog;
+    }
+
+    static void test_02()
+    {
+        auto catalog{ makeCatalog() };
+
+        BookTable table{};
+        table.reserve(catalog.size());
+        for (const auto& book : catalog) {
+            table.push_back(book);
+        }
+
+        auto since1990 = [](int year) { return year >= 1990; };
+
+        std::println("Query: sum of prices of all books since 1990");
+
+        double sum{};
+        std::println("filter / map / foldLeft on std::vector<Book>:");
+        {
+            ScopedTimer watch{};
+
+            sum = foldLeft(
+                map(
+                    filter(catalog, [&](const Book& book) { return since1990(book.m_year); }),
+                    [](const Book& book) { return book.m_price; }
+                ),
+                0.0,
+                std::plus<double>{}
+            );
+        }
+        std::println("Sum: {:.2f}", sum);
+
+        std::println("std::accumulate on std::vector<Book> (no intermediate containers):");
+        {
+            ScopedTimer watch{};
+
+            sum = std::accumulate(catalog.begin(), catalog.end(), 0.0, [&](double acc, const Book& book) {
+                return since1990(book.m_year) ? acc + book.m_price : acc;
+            });
+        }
+        std::println("Sum: {:.2f}", sum);
+
+        std::println("ColumnTable - select + sum:");
+        {
+            ScopedTimer watch{};
+
+            Selection selection{ table.select<&Book::m_year>(since1990) };
+            sum = table.sum<&Book::m_price>(selection);
+        }
+        std::println("Sum: {:.2f}", sum);
+
+        std::println("ColumnTable - sumWhere:");
+        {
+            ScopedTimer watch{};
+            sum = table.sumWhere<&Book::m_price, &Book::m_year>(since1990);
+        }
+        std::println("Sum: {:.2f}", sum);
+
+        std::println();
+        std::println("Query: number of books since 1990, cheaper than 10.00, by Bjarne Stroustrup");
+
+        std::size_t count{};
+        std::println("filter / filter / filter on std::vector<Book>:");
+        {
+            ScopedTimer watch{};
+
+            count = filter(
+                filter(
+                    filter(catalog, [&](const Book& book) { return since1990(book.m_year); }),
+                    [](const Book& book) { return book.m_price < 10.0; }
+                ),
+                [](const Book& book) { return book.m_author == "Bjarne Stroustrup"; }
+            ).size();
+        }
+        std::println("Count: {}", count);
+
+        std::println("ColumnTable - select + refine + refine:");
+        {
+            ScopedTimer watch{};
+
+            Selection selection{ table.select<&Book::m_year>(since1990) };
+            table.refine<&Book::m_price>(selection, [](double price) { return price < 10.0; });
+            table.refine<&Book::m_author>(selection, [](const std::string& author) { return author == "Bjarne Stroustrup"; });
+            count = selection.size();
+        }
+        std::println("Count: {}", count);
+    }
+}
+
+void main_functional_programming_column_table()
+{
+    using namespace FunctionalProgramming_ColumnTable;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -7,6 +7,7 @@ export module modern_cpp:functional_programming;
 export void main_functional_programming();
 export void main_functional_programming_legacy();
 export void main_functional_programming_alternate();
+export void main_functional_programming_column_table();
 
 // =====================================================================================
 // End-of-File
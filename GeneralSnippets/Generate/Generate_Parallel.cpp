@@ -0,0 +1,320 @@
+// =====================================================================================
+// Generate_Parallel.cpp // Parallel std::generate for generators with "jump-ahead"
+// =====================================================================================
+
+module modern_cpp:generate;
+
+import std;
+import scoped_timer;
+
+namespace AlgorithmGenerateParallel {
+
+    // =================================================================================
+    // A stateful generator can be used in parallel, if it is able to skip
+    // n values cheaply: every worker jumps to the offset of its chunk and
+    // continues from there - the output is identical to the serial run.
+    // =================================================================================
+
+    template <typename TGenerator>
+    concept JumpableGenerator = std::copy_constructible<TGenerator> &&
+        requires (TGenerator gen, std::uint64_t n)
+    {
+        { gen() };
+        { gen.skip(n) } -> std::same_as<void>;
+    };
+
+    // =================================================================================
+    // iota: start, start + 1, start + 2, ...
+    // =================================================================================
+
+    template <typename T>
+    class IotaGenerator
+    {
+    private:
+        T m_value;
+
+    public:
+        explicit IotaGenerator(T start = T{}) : m_value{ start } {}
+
+        T operator()() { return m_value++; }
+
+        void skip(std::uint64_t n) { m_value += static_cast<T>(n); }
+    };
+
+    // =================================================================================
+    // arithmetic progression: start, start + step, start + 2 * step, ...
+    // Every value is computed from its index - for floating point types a running sum
+    // would accumulate rounding errors depending on where a chunk starts.
+    // =================================================================================
+
+    template <typename T>
+    class ArithmeticGenerator
+    {
+    private:
+        T             m_start;
+        T             m_step;
+        std::uint64_t m_index;
+
+    public:
+        ArithmeticGenerator(T start, T step) : m_start{ start }, m_step{ step }, m_index{} {}
+
+        T operator()() { return m_start + static_cast<T>(m_index++) * m_step; }
+
+        void skip(std::uint64_t n) { m_index += n; }
+    };
+
+    // =================================================================================
+    // geometric progression: start, start * factor, start * factor^2, ...
+    // Integral types only (arithmetic modulo 2^n), so that jumping by n steps
+    // (factor^n with exponentiation by squaring) yields exactly the same values.
+    // =================================================================================
+
+    template <std::unsigned_integral T>
+    class GeometricGenerator
+    {
+    private:
+        T m_value;
+        T m_factor;
+
+    public:
+        GeometricGenerator(T start, T factor) : m_value{ start }, m_factor{ factor } {}
+
+        T operator()() {
+            T result{ m_value };
+            m_value *= m_factor;
+            return result;
+        }
+
+        void skip(std::uint64_t n) {
+            T base{ m_factor };
+            T power{ 1 };
+            while (n != 0) {
+                if (n & 1) {
+                    power *= base;
+                }
+                base *= base;
+                n >>= 1;
+            }
+            m_value *= power;
+        }
+    };
+
+    // =================================================================================
+    // random numbers: SplitMix64 is a counter-based generator,
+    // the state advances by a constant, so skipping costs one multiplication
+    // =================================================================================
+
+    class SplitMix64Generator
+    {
+    private:
+        static constexpr std::uint64_t Gamma{ 0x9E3779B97F4A7C15ull };
+
+        std::uint64_t m_state;
+
+    public:
+        explicit SplitMix64Generator(std::uint64_t seed = 0) : m_state{ seed } {}
+
+        std::uint64_t operator()() {
+            std::uint64_t z{ m_state += Gamma };
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        void skip(std::uint64_t n) { m_state += n * Gamma; }
+    };
+
+    // uniformly distributed doubles in [low, high)
+    class UniformRealGenerator
+    {
+    private:
+        SplitMix64Generator m_engine;
+        double              m_low;
+        double              m_range;
+
+    public:
+        UniformRealGenerator(std::uint64_t seed, double low, double high)
+            : m_engine{ seed }, m_low{ low }, m_range{ high - low }
+        {}
+
+        double operator()() {
+            // upper 53 bits form the mantissa of a value in [0, 1)
+            const double unit{ static_cast<double>(m_engine() >> 11) * 0x1.0p-53 };
+            return m_low + unit * m_range;
+        }
+
+        void skip(std::uint64_t n) { m_engine.skip(n); }
+    };
+
+    static_assert(JumpableGenerator<IotaGenerator<int>>);
+    static_assert(JumpableGenerator<ArithmeticGenerator<double>>);
+    static_assert(JumpableGenerator<GeometricGenerator<std::uint64_t>>);
+    static_assert(JumpableGenerator<SplitMix64Generator>);
+    static_assert(JumpableGenerator<UniformRealGenerator>);
+
+    // =================================================================================
+    // parallelGenerate
+    //
+    // The range is split into chunks, each chunk gets its own copy of the generator,
+    // positioned with skip(). The chunks are processed with std::for_each using
+    // the given execution policy.
+    // =================================================================================
+
+    template <typename TPolicy, std::ranges::random_access_range TRange, JumpableGenerator TGenerator>
+        requires std::is_execution_policy_v<std::remove_cvref_t<TPolicy>> &&
+                 std::ranges::sized_range<TRange>
+    static void parallelGenerate(TPolicy&& policy, TRange&& range, TGenerator gen)
+    {
+        const std::size_t size{ std::ranges::size(range) };
+        const auto first{ std::ranges::begin(range) };
+
+        if constexpr (std::is_same_v<std::remove_cvref_t<TPolicy>, std::execution::sequenced_policy>) {
+            std::generate(first, first + size, gen);
+        }
+        else {
+            // a few chunks per hardware thread balance the load
+            static constexpr std::size_t MinChunkSize{ 64 * 1024 };
+
+            const std::size_t maxChunks{ 4 * std::max(1u, std::thread::hardware_concurrency()) };
+            const std::size_t numChunks{ std::clamp<std::size_t>(size / MinChunkSize, 1, maxChunks) };
+            const std::size_t chunkSize{ (size + numChunks - 1) / numChunks };
+
+            std::vector<std::size_t> chunks(numChunks);
+            std::iota(chunks.begin(), chunks.end(), std::size_t{});
+
+            std::for_each(
+                std::forward<TPolicy>(policy),
+                chunks.begin(),
+                chunks.end(),
+                [&](std::size_t chunk) {
+                    const std::size_t begin{ std::min(size, chunk * chunkSize) };
+                    const std::size_t end{ std::min(size, begin + chunkSize) };
+
+                    TGenerator local{ gen };
+                    local.skip(begin);
+                    std::generate(first + begin, first + end, local);
+                }
+            );
+        }
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    template <typename T>
+    static void printValues(std::string_view label, const std::vector<T>& values)
+    {
+        std::print("{:<12}", label);
+        for (const auto& value : values) {
+            std::print("{} ", value);
+        }
+        std::println();
+    }
+
+    static void test_01()
+    {
+        std::vector<int> values(10);
+
+        parallelGenerate(std::execution::seq, values, IotaGenerator<int>{ 1 });
+        printValues("Iota:", values);
+
+        std::vector<double> progression(10);
+        parallelGenerate(std::execution::par, progression, ArithmeticGenerator<double>{ 0.5, 0.25 });
+        printValues("Arithmetic:", progression);
+
+        std::vector<std::uint64_t> powers(10);
+        parallelGenerate(std::execution::par, powers, GeometricGenerator<std::uint64_t>{ 1, 3 });
+        printValues("Geometric:", powers);
+    }
+
+    static void test_02()
+    {
+        // serial and parallel run have to produce identical results
+        std::vector<std::uint64_t> serial(1'000'000);
+        std::vector<std::uint64_t> parallel(serial.size());
+
+        std::generate(serial.begin(), serial.end(), GeometricGenerator<std::uint64_t>{ 7, 5 });
+        parallelGenerate(std::execution::par, parallel, GeometricGenerator<std::uint64_t>{ 7, 5 });
+        std::println("Geometric:   serial == parallel: {}", serial == parallel);
+
+        std::generate(serial.begin(), serial.end(), SplitMix64Generator{ 123 });
+        parallelGenerate(std::execution::par, parallel, SplitMix64Generator{ 123 });
+        std::println("SplitMix64:  serial == parallel: {}", serial == parallel);
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t VectorSize = 10'000'000;     // debug
+#else
+    static constexpr std::size_t VectorSize = 100'000'000;    // release
+#endif
+
+    static void test_03()
+    {
+        std::vector<double> values(VectorSize);
+        std::vector<double> results(VectorSize);
+
+        std::println("std::generate with stateful lambda (std::mt19937_64):");
+        {
+            ScopedTimer watch{};
+
+            std::generate(
+                values.begin(),
+                values.end(),
+                [engine = std::mt19937_64{ 1 }, distribution = std::uniform_real_distribution<double>{ 0.0, 1.0 }]() mutable {
+                    return distribution(engine);
+                }
+            );
+        }
+
+        std::println("std::generate (UniformRealGenerator):");
+        {
+            ScopedTimer watch{};
+            std::generate(values.begin(), values.end(), UniformRealGenerator{ 1, 0.0, 1.0 });
+        }
+
+        std::println("parallelGenerate - std::execution::seq:");
+        {
+            ScopedTimer watch{};
+            parallelGenerate(std::execution::seq, results, UniformRealGenerator{ 1, 0.0, 1.0 });
+        }
+
+        std::println("parallelGenerate - std::execution::par:");
+        {
+            ScopedTimer watch{};
+            parallelGenerate(std::execution::par, results, UniformRealGenerator{ 1, 0.0, 1.0 });
+        }
+
+        std::println("Results identical: {}", values == results);
+
+        std::println("std::generate (ArithmeticGenerator):");
+        {
+            ScopedTimer watch{};
+            std::generate(values.begin(), values.end(), ArithmeticGenerator<double>{ 0.0, 0.5 });
+        }
+
+        std::println("parallelGenerate - std::execution::par (ArithmeticGenerator):");
+        {
+            ScopedTimer watch{};
+            parallelGenerate(std::execution::par, results, ArithmeticGenerator<double>{ 0.0, 0.5 });
+        }
+
+        std::println("Results identical: {}", values == results);
+    }
+}
+
+void main_generate_parallel()
+{
+    using namespace AlgorithmGenerateParallel;
+    test_01();
+    test_02();
+    test_03();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,7 @@
 export module modern_cpp:generate;
 
 export void main_generate();
+export void main_generate_parallel();
 
 // =====================================================================================
 // End-of-File
@@ -5,6 +5,7 @@
 export module modern_cpp:placement_new;
 
 export void main_placement_new();
+export void main_placement_new_static_vector();
 
 // =====================================================================================
 // End-of-File
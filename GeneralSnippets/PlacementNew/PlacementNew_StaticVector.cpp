@@ -0,0 +1,860 @@
+// =====================================================================================
+// PlacementNew_StaticVector.cpp // Vectors with inline storage: static_vector and small_vector
+// =====================================================================================
+
+module modern_cpp:placement_new;
+
+import std;
+import scoped_timer;
+
+namespace PlacementNewStaticVector {
+
+    // =================================================================================
+    // VectorEx<T> in PlacementNew.cpp shows the principle: raw memory, elements
+    // constructed with placement new. Here the idea is completed:
+    //
+    // static_vector<T, N>: capacity N, elements live inside of the object -
+    //                      no heap allocation at all
+    // small_vector<T, N>:  the first N elements live inside of the object,
+    //                      the heap is used only beyond N elements
+    //
+    // Both types share their std::vector-like interface (VectorInterface, CRTP).
+    // Operations at the end (push_back, emplace_back, resize, reserve) and the
+    // constructors provide the strong exception guarantee, insert and erase in
+    // the middle the same guarantees as std::vector.
+    // =================================================================================
+
+    // =================================================================================
+    // relocation: move count objects from first to dest and end their lifetime
+    // at first - trivially copyable types are copied byte by byte
+    // =================================================================================
+
+    template <typename T>
+    static void relocate(T* first, std::size_t count, T* dest)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+            }
+        }
+        else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(first, count, dest);
+            std::destroy_n(first, count);
+        }
+        else {
+            // a throwing move c'tor would leave the source damaged:
+            // copy, the source stays intact, if a copy c'tor throws
+            std::uninitialized_copy_n(first, count, dest);
+            std::destroy_n(first, count);
+        }
+    }
+
+    // =================================================================================
+    // VectorInterface: everything except storage management
+    //
+    // TDerived provides
+    //   T* storage() / const T* storage() const  -  first element
+    //   std::size_t capacity() const
+    //   void grow(std::size_t minCapacity)       -  throws std::length_error, if not possible
+    // =================================================================================
+
+    template <typename TDerived, typename T>
+    class VectorInterface
+    {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    protected:
+        std::size_t m_size{};
+
+        TDerived& derived() noexcept { return static_cast<TDerived&>(*this); }
+        const TDerived& derived() const noexcept { return static_cast<const TDerived&>(*this); }
+
+    public:
+        // =============================================================================
+        // size
+        // =============================================================================
+
+        std::size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+
+        void reserve(std::size_t capacity)
+        {
+            if (capacity > derived().capacity()) {
+                derived().grow(capacity);
+            }
+        }
+
+        // =============================================================================
+        // element access
+        // =============================================================================
+
+        T* data() noexcept { return derived().storage(); }
+        const T* data() const noexcept { return derived().storage(); }
+
+        T& operator[] (std::size_t index) noexcept { return data()[index]; }
+        const T& operator[] (std::size_t index) const noexcept { return data()[index]; }
+
+        T& at(std::size_t index) {
+            if (index >= m_size) {
+                throw std::out_of_range{ "Index out of range" };
+            }
+            return data()[index];
+        }
+
+        const T& at(std::size_t index) const {
+            if (index >= m_size) {
+                throw std::out_of_range{ "Index out of range" };
+            }
+            return data()[index];
+        }
+
+        T& front() noexcept { return data()[0]; }
+        const T& front() const noexcept { return data()[0]; }
+        T& back() noexcept { return data()[m_size - 1]; }
+        const T& back() const noexcept { return data()[m_size - 1]; }
+
+        // =============================================================================
+        // iterators
+        // =============================================================================
+
+        iterator begin() noexcept { return data(); }
+        iterator end() noexcept { return data() + m_size; }
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator end() const noexcept { return data() + m_size; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+        reverse_iterator rbegin() noexcept { return reverse_iterator{ end() }; }
+        reverse_iterator rend() noexcept { return reverse_iterator{ begin() }; }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{ end() }; }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator{ begin() }; }
+        const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+        const_reverse_iterator crend() const noexcept { return rend(); }
+
+        // =============================================================================
+        // modifiers at the end
+        // =============================================================================
+
+        template <typename... TArgs>
+        T& emplace_back(TArgs&&... args)
+        {
+            if (m_size == derived().capacity()) {
+                // args may refer to an element of this vector:
+                // create the new element before the elements are relocated
+                T value(std::forward<TArgs>(args)...);
+                derived().grow(std::max(2 * derived().capacity(), m_size + 1));
+                return append(std::move(value));
+            }
+
+            return append(std::forward<TArgs>(args)...);
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back() noexcept
+        {
+            --m_size;
+            std::destroy_at(data() + m_size);
+        }
+
+        void clear() noexcept
+        {
+            std::destroy_n(data(), m_size);
+            m_size = 0;
+        }
+
+        void resize(std::size_t size)
+        {
+            if (size <= m_size) {
+                truncate(size);
+                return;
+            }
+
+            reserve(size);
+            std::uninitialized_value_construct_n(end(), size - m_size);   // cleans up on exception
+            m_size = size;
+        }
+
+        void resize(std::size_t size, const T& value)
+        {
+            if (size <= m_size) {
+                truncate(size);
+                return;
+            }
+
+            if (size > derived().capacity()) {
+                T copy(value);   // value may be an element of this vector
+                derived().grow(size);
+                std::uninitialized_fill_n(end(), size - m_size, copy);
+            }
+            else {
+                std::uninitialized_fill_n(end(), size - m_size, value);
+            }
+            m_size = size;
+        }
+
+        // =============================================================================
+        // modifiers at arbitrary positions
+        // =============================================================================
+
+        template <typename... TArgs>
+        iterator emplace(const_iterator pos, TArgs&&... args)
+        {
+            const std::size_t index{ static_cast<std::size_t>(pos - begin()) };
+            emplace_back(std::forward<TArgs>(args)...);
+            std::rotate(begin() + index, end() - 1, end());
+            return begin() + index;
+        }
+
+        iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+        iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+        iterator insert(const_iterator pos, std::size_t count, const T& value)
+        {
+            const std::size_t index{ static_cast<std::size_t>(pos - begin()) };
+            const std::size_t oldSize{ m_size };
+            resize(m_size + count, value);
+            std::rotate(begin() + index, begin() + oldSize, end());
+            return begin() + index;
+        }
+
+        template <std::input_iterator TIterator>
+        iterator insert(const_iterator pos, TIterator first, TIterator last)
+        {
+            const std::size_t index{ static_cast<std::size_t>(pos - begin()) };
+            const std::size_t oldSize{ m_size };
+            append(first, last);
+            std::rotate(begin() + index, begin() + oldSize, end());
+            return begin() + index;
+        }
+
+        iterator insert(const_iterator pos, std::initializer_list<T> values) {
+            return insert(pos, values.begin(), values.end());
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            const std::size_t index{ static_cast<std::size_t>(first - begin()) };
+            const std::size_t count{ static_cast<std::size_t>(last - first) };
+
+            std::move(begin() + index + count, end(), begin() + index);
+            truncate(m_size - count);
+            return begin() + index;
+        }
+
+        void assign(std::size_t count, const T& value)
+        {
+            clear();
+            resize(count, value);
+        }
+
+        template <std::input_iterator TIterator>
+        void assign(TIterator first, TIterator last)
+        {
+            clear();
+            append(first, last);
+        }
+
+        void assign(std::initializer_list<T> values) {
+            assign(values.begin(), values.end());
+        }
+
+        // =============================================================================
+        // comparison
+        // =============================================================================
+
+        friend bool operator== (const TDerived& lhs, const TDerived& rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        friend auto operator<=> (const TDerived& lhs, const TDerived& rhs)
+            requires std::three_way_comparable<T>
+        {
+            return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+    protected:
+        // precondition: size() < capacity()
+        template <typename... TArgs>
+        T& append(TArgs&&... args)
+        {
+            T* element{ std::construct_at(end(), std::forward<TArgs>(args)...) };
+            ++m_size;
+            return *element;
+        }
+
+        template <std::input_iterator TIterator>
+        void append(TIterator first, TIterator last)
+        {
+            if constexpr (std::forward_iterator<TIterator>) {
+                const std::size_t count{ static_cast<std::size_t>(std::distance(first, last)) };
+                reserve(m_size + count);
+                std::uninitialized_copy(first, last, end());   // cleans up on exception
+                m_size += count;
+            }
+            else {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        void truncate(std::size_t size) noexcept
+        {
+            std::destroy(begin() + size, end());
+            m_size = size;
+        }
+
+        // element-wise swap of two vectors, both elements in inline storage
+        void swapElements(TDerived& other)
+        {
+            TDerived& shorter{ m_size <= other.m_size ? derived() : other };
+            TDerived& longer{ m_size <= other.m_size ? other : derived() };
+
+            const std::size_t common{ shorter.m_size };
+            std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+            std::uninitialized_move(longer.begin() + common, longer.end(), shorter.end());
+            std::destroy(longer.begin() + common, longer.end());
+            std::swap(shorter.m_size, longer.m_size);
+        }
+    };
+
+    // =================================================================================
+    // static_vector<T, N>
+    // =================================================================================
+
+    template <typename T, std::size_t N>
+    class static_vector : public VectorInterface<static_vector<T, N>, T>
+    {
+        static_assert(N > 0, "static_vector needs a capacity");
+
+    private:
+        friend class VectorInterface<static_vector<T, N>, T>;
+
+        alignas(T) unsigned char m_storage[N * sizeof(T)];
+
+        T* storage() noexcept { return reinterpret_cast<T*>(m_storage); }
+        const T* storage() const noexcept { return reinterpret_cast<const T*>(m_storage); }
+
+        [[noreturn]] void grow(std::size_t) {
+            throw std::length_error{ "static_vector: capacity exceeded" };
+        }
+
+    public:
+        static_vector() noexcept {}
+
+        // all other c'tors delegate to the default c'tor first:
+        // if their body throws, the d'tor destroys the elements created so far
+
+        explicit static_vector(std::size_t count) : static_vector{} {
+            this->resize(count);
+        }
+
+        static_vector(std::size_t count, const T& value) : static_vector{} {
+            this->resize(count, value);
+        }
+
+        template <std::input_iterator TIterator>
+        static_vector(TIterator first, TIterator last) : static_vector{} {
+            this->append(first, last);
+        }
+
+        static_vector(std::initializer_list<T> values) : static_vector{} {
+            this->append(values.begin(), values.end());
+        }
+
+        static_vector(const static_vector& other) : static_vector{} {
+            this->append(other.begin(), other.end());
+        }
+
+        static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : static_vector{}
+        {
+            std::uninitialized_move_n(other.begin(), other.size(), this->begin());
+            this->m_size = other.m_size;
+            other.clear();
+        }
+
+        ~static_vector() {
+            this->clear();
+        }
+
+        static_vector& operator= (const static_vector& other)
+        {
+            if (this != &other) {
+                static_vector copy{ other };
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        static_vector& operator= (static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &other) {
+                this->clear();
+                std::uninitialized_move_n(other.begin(), other.size(), this->begin());
+                this->m_size = other.m_size;
+                other.clear();
+            }
+            return *this;
+        }
+
+        static constexpr std::size_t capacity() noexcept { return N; }
+        static constexpr std::size_t max_size() noexcept { return N; }
+
+        bool full() const noexcept { return this->m_size == N; }
+
+        void swap(static_vector& other) {
+            this->swapElements(other);
+        }
+
+        friend void swap(static_vector& lhs, static_vector& rhs) { lhs.swap(rhs); }
+    };
+
+    // =================================================================================
+    // small_vector<T, N>
+    // =================================================================================
+
+    template <typename T, std::size_t N>
+    class small_vector : public VectorInterface<small_vector<T, N>, T>
+    {
+        static_assert(N > 0, "small_vector needs an inline capacity");
+
+    private:
+        friend class VectorInterface<small_vector<T, N>, T>;
+
+        T*          m_data;          // inline storage or heap
+        std::size_t m_capacity;
+
+        alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+        T* inlineStorage() noexcept { return reinterpret_cast<T*>(m_inline); }
+
+        T* storage() noexcept { return m_data; }
+        const T* storage() const noexcept { return m_data; }
+
+        void grow(std::size_t minCapacity)
+        {
+            reallocate(minCapacity);
+        }
+
+        // strong guarantee: on exception the elements are still in the old buffer
+        void reallocate(std::size_t capacity)
+        {
+            std::allocator<T> allocator{};
+            T* data{ allocator.allocate(capacity) };
+
+            try {
+                relocate(m_data, this->m_size, data);
+            }
+            catch (...) {
+                allocator.deallocate(data, capacity);
+                throw;
+            }
+
+            release();
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        void release() noexcept
+        {
+            if (!isInline()) {
+                std::allocator<T>{}.deallocate(m_data, m_capacity);
+            }
+        }
+
+        // precondition: this vector is empty and uses its inline storage
+        void takeFrom(small_vector& other)
+        {
+            if (other.isInline()) {
+                std::uninitialized_move_n(other.begin(), other.size(), this->begin());
+                this->m_size = other.m_size;
+                other.clear();
+            }
+            else {
+                // steal the heap buffer
+                m_data = std::exchange(other.m_data, other.inlineStorage());
+                m_capacity = std::exchange(other.m_capacity, N);
+                this->m_size = std::exchange(other.m_size, 0);
+            }
+        }
+
+    public:
+        small_vector() noexcept : m_data{ inlineStorage() }, m_capacity{ N } {}
+
+        // all other c'tors delegate to the default c'tor first:
+        // if their body throws, the d'tor destroys the elements created so far
+
+        explicit small_vector(std::size_t count) : small_vector{} {
+            this->resize(count);
+        }
+
+        small_vector(std::size_t count, const T& value) : small_vector{} {
+            this->resize(count, value);
+        }
+
+        template <std::input_iterator TIterator>
+        small_vector(TIterator first, TIterator last) : small_vector{} {
+            this->append(first, last);
+        }
+
+        small_vector(std::initializer_list<T> values) : small_vector{} {
+            this->append(values.begin(), values.end());
+        }
+
+        small_vector(const small_vector& other) : small_vector{} {
+            this->append(other.begin(), other.end());
+        }
+
+        small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : small_vector{}
+        {
+            takeFrom(other);
+        }
+
+        ~small_vector()
+        {
+            this->clear();
+            release();
+        }
+
+        small_vector& operator= (const small_vector& other)
+        {
+            if (this != &other) {
+                small_vector copy{ other };
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        small_vector& operator= (small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &other) {
+                this->clear();
+                release();
+                m_data = inlineStorage();
+                m_capacity = N;
+                takeFrom(other);
+            }
+            return *this;
+        }
+
+        std::size_t capacity() const noexcept { return m_capacity; }
+
+        static constexpr std::size_t inline_capacity() noexcept { return N; }
+
+        bool isInline() const noexcept {
+            return m_data == reinterpret_cast<const T*>(m_inline);
+        }
+
+        void shrink_to_fit()
+        {
+            if (isInline() || this->m_size == m_capacity) {
+                return;
+            }
+
+            if (this->m_size <= N) {
+                // back into the inline storage
+                T* data{ m_data };
+                relocate(data, this->m_size, inlineStorage());
+                std::allocator<T>{}.deallocate(data, m_capacity);
+                m_data = inlineStorage();
+                m_capacity = N;
+            }
+            else {
+                reallocate(this->m_size);
+            }
+        }
+
+        void swap(small_vector& other)
+        {
+            if (isInline() || other.isInline()) {
+                small_vector tmp{ std::move(other) };
+                other = std::move(*this);
+                *this = std::move(tmp);
+            }
+            else {
+                std::swap(m_data, other.m_data);
+                std::swap(m_capacity, other.m_capacity);
+                std::swap(this->m_size, other.m_size);
+            }
+        }
+
+        friend void swap(small_vector& lhs, small_vector& rhs) { lhs.swap(rhs); }
+    };
+
+    // =================================================================================
+    // User (as in PlacementNew.cpp) - no default c'tor
+    // =================================================================================
+
+    class User
+    {
+    private:
+        std::string m_name;
+        int m_age;
+
+    public:
+        User(const std::string& name, int age) : m_name{ name }, m_age{ age } {}
+
+        std::string getName() const { return m_name; }
+        int getAge() const { return m_age; }
+
+        void print() const {
+            std::println("Name: {} - Age: {}.", m_name, m_age);
+        }
+    };
+
+    // copy c'tor throws on request, counts living instances
+    class Fragile
+    {
+    private:
+        int m_value;
+
+    public:
+        static inline int s_instances{};
+        static inline bool s_throwOnCopy{};
+
+        explicit Fragile(int value) : m_value{ value } { ++s_instances; }
+
+        Fragile(const Fragile& other) : m_value{ other.m_value }
+        {
+            if (s_throwOnCopy) {
+                throw std::runtime_error{ "Fragile: copy failed" };
+            }
+            ++s_instances;
+        }
+
+        ~Fragile() { --s_instances; }
+
+        Fragile& operator= (const Fragile&) = default;
+
+        int value() const { return m_value; }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        static_vector<User, 4> users{};
+
+        users.push_back(User{ "John", 50 });
+        users.emplace_back("Jack", 30);
+        users.emplace(users.begin(), "Anne", 40);
+
+        for (const auto& user : users) {
+            user.print();
+        }
+
+        users.emplace_back("Sue", 20);
+        std::println("Size: {} - Full: {}", users.size(), users.full());
+
+        try {
+            users.emplace_back("Tom", 60);
+        }
+        catch (const std::length_error& e) {
+            std::println("Exception: {} - Size: {}", e.what(), users.size());
+        }
+
+        users.erase(users.begin() + 1);
+        for (const auto& user : users) {
+            user.print();
+        }
+    }
+
+    static void test_02()
+    {
+        small_vector<std::string, 4> words{ "one", "two", "three" };
+        std::println("Size: {} - Capacity: {} - Inline: {}", words.size(), words.capacity(), words.isInline());
+
+        words.push_back("four");
+
+        // size() == capacity(): the element of the vector itself is inserted while growing
+        words.push_back(words.front());
+        std::println("Size: {} - Capacity: {} - Inline: {}", words.size(), words.capacity(), words.isInline());
+        std::println("Pushed front while growing: {}", words.back());
+
+        words.push_back("five");
+        std::println("Size: {} - Capacity: {} - Inline: {}", words.size(), words.capacity(), words.isInline());
+
+        words.insert(words.begin() + 1, { "a", "b" });
+        words.erase(words.end() - 3, words.end());
+        for (const auto& word : words) {
+            std::print("{} ", word);
+        }
+        std::println();
+
+        words.resize(3);
+        words.shrink_to_fit();
+        std::println("Size: {} - Capacity: {} - Inline: {}", words.size(), words.capacity(), words.isInline());
+
+        small_vector<std::string, 4> other{ "x" };
+        other.swap(words);
+        std::println("{} - {}", words.size(), other.size());
+        std::println("Equal: {} - Less: {}", words == other, words < other);
+    }
+
+    static void test_03()
+    {
+        // strong guarantee: failing relocation leaves the vector unchanged
+        {
+            small_vector<Fragile, 2> values{};
+            values.emplace_back(1);
+            values.emplace_back(2);
+
+            Fragile::s_throwOnCopy = true;
+            try {
+                values.emplace_back(3);   // needs to relocate - Fragile has no move c'tor
+            }
+            catch (const std::runtime_error& e) {
+                std::println("Exception: {}", e.what());
+            }
+            Fragile::s_throwOnCopy = false;
+
+            std::println("Size: {} - Inline: {} - Values: {} {}",
+                values.size(), values.isInline(), values[0].value(), values[1].value());
+        }
+
+        // failing c'tor: no leaked elements
+        try {
+            Fragile value{ 42 };
+            static_vector<Fragile, 8> values(4, value);
+            Fragile::s_throwOnCopy = true;
+            static_vector<Fragile, 8> copy{ values };
+        }
+        catch (const std::runtime_error& e) {
+            std::println("Exception: {}", e.what());
+        }
+        Fragile::s_throwOnCopy = false;
+
+        std::println("Living instances: {}", Fragile::s_instances);
+    }
+
+    // =================================================================================
+    // benchmark: many short-lived vectors with few elements
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t Iterations = 1'000'000;       // debug
+#else
+    static constexpr std::size_t Iterations = 20'000'000;      // release
+#endif
+
+    template <typename TVector>
+    static std::size_t fillAndSum(const std::vector<std::uint8_t>& sizes)
+    {
+        std::size_t total{};
+
+        for (std::size_t i{}; i != Iterations; ++i) {
+
+            TVector values{};
+            const std::size_t size{ sizes[i % sizes.size()] };
+
+            for (std::size_t k{}; k != size; ++k) {
+                values.push_back(static_cast<int>(i + k));
+            }
+
+            for (int value : values) {
+                total += static_cast<std::size_t>(value);
+            }
+        }
+
+        return total;
+    }
+
+    static std::vector<std::uint8_t> makeSizes(std::size_t maxSize)
+    {
+        std::mt19937 engine{ 42 };
+        std::uniform_int_distribution<int> distribution{ 0, static_cast<int>(maxSize) };
+
+        std::vector<std::uint8_t> sizes(4096);
+        for (auto& size : sizes) {
+            size = static_cast<std::uint8_t>(distribution(engine));
+        }
+        return sizes;
+    }
+
+    static void test_04()
+    {
+        std::println("0 ... 8 elements:");
+
+        const auto sizes{ makeSizes(8) };
+        std::size_t total{};
+
+        std::print("std::vector<int>:          ");
+        {
+            ScopedTimer watch{};
+            total = fillAndSum<std::vector<int>>(sizes);
+        }
+        std::println("  Total: {}", total);
+
+        std::print("static_vector<int, 8>:     ");
+        {
+            ScopedTimer watch{};
+            total = fillAndSum<static_vector<int, 8>>(sizes);
+        }
+        std::println("  Total: {}", total);
+
+        std::print("small_vector<int, 8>:      ");
+        {
+            ScopedTimer watch{};
+            total = fillAndSum<small_vector<int, 8>>(sizes);
+        }
+        std::println("  Total: {}", total);
+    }
+
+    static void test_05()
+    {
+        std::println("0 ... 16 elements (small_vector spills to the heap):");
+
+        const auto sizes{ makeSizes(16) };
+        std::size_t total{};
+
+        std::print("std::vector<int>:          ");
+        {
+            ScopedTimer watch{};
+            total = fillAndSum<std::vector<int>>(sizes);
+        }
+        std::println("  Total: {}", total);
+
+        std::print("small_vector<int, 8>:      ");
+        {
+            ScopedTimer watch{};
+            total = fillAndSum<small_vector<int, 8>>(sizes);
+        }
+        std::println("  Total: {}", total);
+    }
+}
+
+void main_placement_new_static_vector()
+{
+    using namespace PlacementNewStaticVector;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+    test_05();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -21,10 +21,13 @@ int main()
     try
     {
         //main_accumulate();
+        //main_accumulate_string_builder();
         //main_algorithms();
         //main_all_of_any_of_none_of();
+        //main_all_of_any_of_none_of_flag_vector();
         //main_allocator();
         //main_any();
+        //main_any_columnar_sheet();
         //main_argument_dependent_name_lookup();
         //main_array();
         //main_array_decay();
@@ -40,22 +43,29 @@ int main()
         //main_const_variants();
         //main_constexpr();
         //main_constexpr_crc();
+        //main_constexpr_lookup_table();
         //main_constructor_invocations();
         //main_copy_move_elision();
         //main_copy_swap_idiom();
         //main_crtp();
+        //main_crtp_image_pipeline();
+        //main_crtp_control_collection();
         //main_decltype();
         //main_default_initialization();
         //main_erase_remove_idiom();
         //main_expression_templates();
         //main_exception_safety();
         //main_expected();
+        //main_expected_error_code();
         //main_explicit_keyword();
         //main_folding();
+        //main_folding_binary_logger();
         //main_functional_programming();
         //main_functional_programming_legacy();
         //main_functional_programming_alternate();
+        //main_functional_programming_column_table();
         //main_generate();
+        //main_generate_parallel();
         //main_generic_functions();
         //main_initializer_list();
         //main_input_output_streams();  
@@ -73,6 +83,7 @@ int main()
         //main_optional();
         //main_perfect_forwarding();
         //main_placement_new();
+        //main_placement_new_static_vector();
         //main_println();
         //main_raii();
         //main_raii_02();
@@ -84,11 +95,15 @@ int main()
         //main_rvalue_lvalue();
         //main_sfinae();
         //main_shared_ptr();
+        //main_shared_ptr_local_intrusive();
+        //main_shared_ptr_atomic_publisher();
         //main_source_location();
         //main_spaceship_operator();
         //main_sso();
+        //main_sso_small_string();
         //main_static_assert();
         //main_string_view();
+        //main_string_view_scanning();
         //main_structured_binding();
         //main_templates_class_basics_01();
         //main_templates_class_basics_02();
@@ -98,20 +113,29 @@ int main()
         //main_templates_specialization();
         //main_to_underlying();
         //main_transform();
+        //main_transform_string_interning();
+        //main_transform_views();
         //main_tuple(); 
+        //main_tuple_soa_vector();
         //main_two_phase_name_lookup();
         //main_type_erasure();
         //main_type_erasure_bookstore();
         //main_type_traits();
         //main_unique_ptr();
+        //main_unique_ptr_digit_conversion();
+        //main_unique_ptr_pool_deleter();
         //main_variadic_templates_introduction();
         //main_variadic_templates_working_on_every_argument();
         //main_variadic_templates_sum_of_sums();
         //main_variadic_templates_mixins();
+        //main_variadic_templates_concurrent_mixins();
         //main_variant();
+        //main_variant_fast_visit();
         //main_virtual_base_class_destructor();
         //main_virtual_override_final();
         //main_weak_pointer();
+        //main_weak_pointer_epoch_reclamation();
+        //main_weak_pointer_slab_tree();
 
         //main_exercises();
     }
@@ -5,6 +5,7 @@
 export module modern_cpp:sso;
 
 export void main_sso();
+export void main_sso_small_string();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,672 @@
+// =====================================================================================
+// SSO_SmallString.cpp // A string class with configurable SSO capacity
+// =====================================================================================
+
+module modern_cpp:sso;
+
+import std;
+import scoped_timer;
+
+namespace SmallStringOptimization {
+
+    // =================================================================================
+    // BasicSmallString<InlineCapacity, TAllocator, CopyOnWrite>
+    //
+    // - strings up to InlineCapacity characters are stored inside the object,
+    //   no allocation at all
+    // - longer strings are allocated with TAllocator (allocator-aware container)
+    // - the length is stored, length() is O(1); the most significant bit
+    //   of the length member tells, whether the characters are on the heap
+    // - optional copy-on-write: copies of heap strings share the payload
+    //   (one atomic increment), the payload is duplicated before the first mutation
+    //
+    // Layout (64 bit): length (8 bytes) + union of inline buffer and heap data
+    // (pointer, capacity) => sizeof == 32 for InlineCapacity == 23,
+    //                        sizeof == 40 for InlineCapacity == 31
+    // An empty allocator takes no space: MSVC ignores [[no_unique_address]],
+    // it needs its own attribute [[msvc::no_unique_address]]
+    // =================================================================================
+
+    template <std::size_t InlineCapacity = 23, typename TAllocator = std::allocator<char>, bool CopyOnWrite = false>
+    class BasicSmallString
+    {
+    private:
+        static_assert(std::is_same_v<typename std::allocator_traits<TAllocator>::value_type, char>);
+
+        using AllocTraits = std::allocator_traits<TAllocator>;
+
+        // reference count in front of a shared payload (copy-on-write only)
+        struct SharedHeader
+        {
+            std::atomic<std::size_t> m_refs;
+
+            SharedHeader() : m_refs{ 1 } {}
+        };
+
+        using HeaderAllocator = typename AllocTraits::template rebind_alloc<SharedHeader>;
+        using HeaderTraits = std::allocator_traits<HeaderAllocator>;
+
+        static constexpr std::size_t HeapFlag{ std::size_t{ 1 } << (std::numeric_limits<std::size_t>::digits - 1) };
+
+        struct HeapData
+        {
+            char*       m_data;
+            std::size_t m_capacity;   // without terminating '\0'
+        };
+
+        union Storage
+        {
+            char     m_inline[InlineCapacity + 1];
+            HeapData m_heap;
+        };
+
+        std::size_t                      m_length;
+        Storage                          m_storage;
+#if defined(_MSC_VER)
+        [[msvc::no_unique_address]] TAllocator m_allocator;
+#else
+        [[no_unique_address]] TAllocator m_allocator;
+#endif
+
+    public:
+        using allocator_type = TAllocator;
+
+        // c'tors
+        BasicSmallString() noexcept(noexcept(TAllocator{})) : BasicSmallString{ TAllocator{} } {}
+
+        explicit BasicSmallString(const TAllocator& allocator) noexcept
+            : m_length{}, m_storage{}, m_allocator{ allocator }
+        {}
+
+        BasicSmallString(std::string_view string, const TAllocator& allocator = TAllocator{})
+            : BasicSmallString{ allocator }
+        {
+            initFrom(string);
+        }
+
+        BasicSmallString(const char* string, const TAllocator& allocator = TAllocator{})
+            : BasicSmallString{ std::string_view{ string }, allocator }
+        {}
+
+        // copy c'tor - the stored length is used, no std::strlen
+        BasicSmallString(const BasicSmallString& other)
+            : BasicSmallString{ AllocTraits::select_on_container_copy_construction(other.m_allocator) }
+        {
+            copyFrom(other);
+        }
+
+        // move c'tor - the representation is taken over, independent of its kind
+        BasicSmallString(BasicSmallString&& other) noexcept
+            : m_length{ other.m_length }, m_storage{ other.m_storage }, m_allocator{ std::move(other.m_allocator) }
+        {
+            other.resetToEmpty();
+        }
+
+        ~BasicSmallString() {
+            release();
+        }
+
+        // copy assignment
+        BasicSmallString& operator=(const BasicSmallString& other)
+        {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (m_allocator != other.m_allocator) {
+                    release();
+                    resetToEmpty();
+                }
+                m_allocator = other.m_allocator;
+            }
+
+            if (isOnHeap() && !isShared() && other.length() <= capacity() &&
+                !(CopyOnWrite && other.isOnHeap()))
+            {
+                // reuse own buffer
+                setLength(other.length());
+                std::memcpy(data(), other.data(), other.length() + 1);
+            }
+            else {
+                release();
+                resetToEmpty();
+                copyFrom(other);
+            }
+
+            return *this;
+        }
+
+        // move assignment
+        BasicSmallString& operator=(BasicSmallString&& other) noexcept(
+            AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+        {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+                release();
+                if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                    m_allocator = std::move(other.m_allocator);
+                }
+                m_length = other.m_length;
+                m_storage = other.m_storage;
+                other.resetToEmpty();
+            }
+            else {
+                if (m_allocator == other.m_allocator) {
+                    release();
+                    m_length = other.m_length;
+                    m_storage = other.m_storage;
+                    other.resetToEmpty();
+                }
+                else {
+                    assign(other.view());   // different memory resources: copy the characters
+                }
+            }
+
+            return *this;
+        }
+
+        BasicSmallString& operator=(std::string_view string) {
+            assign(string);
+            return *this;
+        }
+
+        BasicSmallString& operator=(const char* string) {
+            assign(std::string_view{ string });
+            return *this;
+        }
+
+        // getter
+        std::size_t length() const noexcept { return m_length & ~HeapFlag; }
+        std::size_t size() const noexcept { return length(); }
+        bool empty() const noexcept { return length() == 0; }
+
+        std::size_t capacity() const noexcept {
+            return isOnHeap() ? m_storage.m_heap.m_capacity : InlineCapacity;
+        }
+
+        static constexpr std::size_t inlineCapacity() noexcept { return InlineCapacity; }
+
+        bool isOnHeap() const noexcept { return (m_length & HeapFlag) != 0; }
+
+        bool isShared() const noexcept {
+            if constexpr (CopyOnWrite) {
+                return isOnHeap() && headerOf(m_storage.m_heap.m_data)->m_refs.load(std::memory_order_acquire) != 1;
+            }
+            else {
+                return false;
+            }
+        }
+
+        allocator_type get_allocator() const noexcept { return m_allocator; }
+
+        const char* data() const noexcept {
+            return isOnHeap() ? m_storage.m_heap.m_data : m_storage.m_inline;
+        }
+
+        const char* c_str() const noexcept { return data(); }
+
+        std::string_view view() const noexcept { return { data(), length() }; }
+
+        operator std::string_view() const noexcept { return view(); }
+
+        // mutable access to a shared payload makes it unique first
+        char* data() {
+            makeUnique();
+            return isOnHeap() ? m_storage.m_heap.m_data : m_storage.m_inline;
+        }
+
+        const char& operator[] (std::size_t index) const noexcept { return data()[index]; }
+
+        char& operator[] (std::size_t index) { return data()[index]; }
+
+        // modifiers
+        void reserve(std::size_t newCapacity)
+        {
+            if (newCapacity > capacity()) {
+                reallocate(newCapacity);
+            }
+            else {
+                makeUnique();
+            }
+        }
+
+        void assign(std::string_view string)
+        {
+            if (string.size() > capacity() || isShared()) {
+                // build the new representation first: string might refer to *this
+                BasicSmallString tmp{ m_allocator };
+                tmp.initFrom(string);
+                swap(tmp);
+                return;
+            }
+
+            char* dest{ data() };
+            std::memmove(dest, string.data(), string.size());
+            dest[string.size()] = '\0';
+            setLength(string.size());
+        }
+
+        BasicSmallString& append(std::string_view string)
+        {
+            const std::size_t oldLength{ length() };
+            const std::size_t newLength{ oldLength + string.size() };
+
+            if (newLength > capacity() || isShared()) {
+                // string might refer to *this: it is copied before the old buffer is released
+                reallocate(std::max(newLength, newLength > capacity() ? 2 * capacity() : capacity()), string);
+                return *this;
+            }
+
+            char* dest{ data() };
+            std::memmove(dest + oldLength, string.data(), string.size());
+            dest[newLength] = '\0';
+            setLength(newLength);
+
+            return *this;
+        }
+
+        BasicSmallString& operator+= (std::string_view string) { return append(string); }
+
+        void push_back(char ch) { append(std::string_view{ &ch, 1 }); }
+
+        void clear()
+        {
+            if (isShared()) {
+                release();
+                resetToEmpty();
+            }
+            else {
+                data()[0] = '\0';
+                setLength(0);
+            }
+        }
+
+        void swap(BasicSmallString& other) noexcept
+        {
+            if constexpr (AllocTraits::propagate_on_container_swap::value) {
+                std::swap(m_allocator, other.m_allocator);
+            }
+            std::swap(m_length, other.m_length);
+            std::swap(m_storage, other.m_storage);
+        }
+
+        friend bool operator== (const BasicSmallString& lhs, const BasicSmallString& rhs) noexcept {
+            return lhs.view() == rhs.view();
+        }
+
+        friend bool operator== (const BasicSmallString& lhs, std::string_view rhs) noexcept {
+            return lhs.view() == rhs;
+        }
+
+    private:
+        static SharedHeader* headerOf(char* data) noexcept {
+            return reinterpret_cast<SharedHeader*>(data) - 1;
+        }
+
+        // number of SharedHeader sized blocks for header and characters
+        static std::size_t blocksFor(std::size_t capacity) noexcept {
+            return 1 + (capacity + 1 + sizeof(SharedHeader) - 1) / sizeof(SharedHeader);
+        }
+
+        void setLength(std::size_t length) noexcept {
+            m_length = length | (m_length & HeapFlag);
+        }
+
+        void resetToEmpty() noexcept {
+            m_length = 0;
+            m_storage.m_inline[0] = '\0';
+        }
+
+        // uninitialized heap buffer of the given capacity, *this is not modified
+        char* allocateBuffer(std::size_t capacity)
+        {
+            if constexpr (CopyOnWrite) {
+                HeaderAllocator allocator{ m_allocator };
+                SharedHeader* header{ HeaderTraits::allocate(allocator, blocksFor(capacity)) };
+                std::construct_at(header);
+                return reinterpret_cast<char*>(header + 1);
+            }
+            else {
+                return AllocTraits::allocate(m_allocator, capacity + 1);
+            }
+        }
+
+        // switches to an uninitialized heap buffer of the given capacity
+        void allocate(std::size_t capacity)
+        {
+            char* buffer{ allocateBuffer(capacity) };
+
+            m_storage.m_heap = HeapData{ buffer, capacity };
+            m_length |= HeapFlag;
+        }
+
+        void deallocate(char* buffer, std::size_t capacity) noexcept
+        {
+            if constexpr (CopyOnWrite) {
+                SharedHeader* header{ headerOf(buffer) };
+                if (header->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    HeaderAllocator allocator{ m_allocator };
+                    std::destroy_at(header);
+                    HeaderTraits::deallocate(allocator, header, blocksFor(capacity));
+                }
+            }
+            else {
+                AllocTraits::deallocate(m_allocator, buffer, capacity + 1);
+            }
+        }
+
+        void release() noexcept
+        {
+            if (isOnHeap()) {
+                deallocate(m_storage.m_heap.m_data, m_storage.m_heap.m_capacity);
+            }
+        }
+
+        // moves the characters and an appended suffix into a new heap buffer
+        // (also removes sharing) - the suffix may refer to the old buffer,
+        // if the allocation throws, *this is unchanged
+        void reallocate(std::size_t newCapacity, std::string_view suffix = {})
+        {
+            const std::size_t oldLength{ length() };
+            const std::size_t newLength{ oldLength + suffix.size() };
+
+            char* buffer{ allocateBuffer(newCapacity) };
+
+            const char* source{ std::as_const(*this).data() };
+            std::memcpy(buffer, source, oldLength);
+            if (!suffix.empty()) {
+                std::memcpy(buffer + oldLength, suffix.data(), suffix.size());
+            }
+            buffer[newLength] = '\0';
+
+            release();
+            m_storage.m_heap = HeapData{ buffer, newCapacity };
+            m_length = newLength | HeapFlag;
+        }
+
+        // keeps the capacity, a following append doesn't reallocate again
+        void makeUnique()
+        {
+            if (isShared()) {
+                reallocate(capacity());
+            }
+        }
+
+        // precondition: *this is empty and doesn't own a buffer
+        void initFrom(std::string_view string)
+        {
+            if (string.size() > InlineCapacity) {
+                allocate(string.size());
+            }
+
+            char* dest{ isOnHeap() ? m_storage.m_heap.m_data : m_storage.m_inline };
+            std::memcpy(dest, string.data(), string.size());
+            dest[string.size()] = '\0';
+            setLength(string.size());
+        }
+
+        // precondition: *this is empty and doesn't own a buffer
+        void copyFrom(const BasicSmallString& other)
+        {
+            if (!other.isOnHeap()) {
+                m_length = other.m_length;
+                std::memcpy(m_storage.m_inline, other.m_storage.m_inline, other.length() + 1);
+            }
+            else if (CopyOnWrite && m_allocator == other.m_allocator) {
+                // share the payload
+                headerOf(other.m_storage.m_heap.m_data)->m_refs.fetch_add(1, std::memory_order_relaxed);
+                m_length = other.m_length;
+                m_storage.m_heap = other.m_storage.m_heap;
+            }
+            else if (other.length() <= InlineCapacity) {
+                m_length = other.length();
+                std::memcpy(m_storage.m_inline, other.data(), other.length() + 1);
+            }
+            else {
+                // the copy is exactly as large as needed
+                allocate(other.length());
+                std::memcpy(m_storage.m_heap.m_data, other.data(), other.length() + 1);
+                setLength(other.length());
+            }
+        }
+    };
+
+    using SmallString = BasicSmallString<23>;
+    using SmallString31 = BasicSmallString<31>;
+    using CowString = BasicSmallString<23, std::allocator<char>, true>;
+
+    // =================================================================================
+    // allocator counting its allocations (stateful)
+    // =================================================================================
+
+    template <typename T>
+    class CountingAllocator
+    {
+    private:
+        std::size_t* m_counter;
+
+        template <typename U>
+        friend class CountingAllocator;
+
+    public:
+        using value_type = T;
+
+        explicit CountingAllocator(std::size_t* counter) noexcept : m_counter{ counter } {}
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>& other) noexcept : m_counter{ other.m_counter } {}
+
+        T* allocate(std::size_t n) {
+            ++*m_counter;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept {
+            std::allocator<T>{}.deallocate(ptr, n);
+        }
+
+        template <typename U>
+        bool operator== (const CountingAllocator<U>& other) const noexcept {
+            return m_counter == other.m_counter;
+        }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        // measured SSO capacity (compare with SSO.cpp)
+        std::println("{:<16} sizeof: {:2}   inline capacity: {}", "std::string", sizeof(std::string), std::string{}.capacity());
+        std::println("{:<16} sizeof: {:2}   inline capacity: {}", "SmallString", sizeof(SmallString), SmallString{}.capacity());
+        std::println("{:<16} sizeof: {:2}   inline capacity: {}", "SmallString31", sizeof(SmallString31), SmallString31{}.capacity());
+        std::println("{:<16} sizeof: {:2}   inline capacity: {}", "CowString", sizeof(CowString), CowString{}.capacity());
+
+        SmallString small{ "ABC" };
+        SmallString large{ "The quick brown fox jumps over the lazy dog" };
+
+        std::println("{} - length: {}, on heap: {}", small.view(), small.length(), small.isOnHeap());
+        std::println("{} - length: {}, on heap: {}", large.view(), large.length(), large.isOnHeap());
+
+        small += " - appended to a small string";
+        std::println("{} - length: {}, on heap: {}", small.view(), small.length(), small.isOnHeap());
+
+        SmallString other{};
+        other = large;              // copy assignment
+        other = std::move(small);   // move assignment: the heap buffer is taken over
+        other = "XYZ";              // fits into the existing buffer
+        std::println("{} - length: {}, on heap: {}", other.view(), other.length(), other.isOnHeap());
+
+        // appending the string to itself, crossing the capacity: the source is the old buffer
+        SmallString self{ "0123456789" };
+        std::string expected{ "0123456789" };
+        for (int i{}; i != 3; ++i) {
+            self += self;           // 20 characters inline, 40 on the heap, 80 on a larger heap
+            expected += expected;
+        }
+        self.push_back(self[0]);
+        expected.push_back(expected[0]);
+        std::println("{} - length: {}, capacity: {}", self.view(), self.length(), self.capacity());
+        std::println("Self-append correct: {}", self == expected);
+    }
+
+    static void test_02()
+    {
+        // copy-on-write
+        CowString original{ "A large immutable payload, shared between copies" };
+        CowString copy{ original };
+
+        std::println("Shared: {} - same buffer: {}", copy.isShared(), copy.c_str() == original.c_str());
+
+        copy[0] = 'a';    // first mutation: the payload is duplicated
+
+        std::println("Shared: {} - same buffer: {}", copy.isShared(), copy.c_str() == original.c_str());
+        std::println("{}", original.view());
+        std::println("{}", copy.view());
+
+        CowString third{};
+        third = original;           // copy assignment shares again
+        std::println("Shared: {}", third.isShared());
+
+        // appending to a shared string with spare capacity
+        CowString grown{ "A heap string, grown by appending" };
+        grown += " - more characters";          // capacity > length now
+        CowString sharing{ grown };
+
+        sharing += "!";                         // fits into the capacity, but the buffer is shared
+        grown += sharing;                       // appends a string sharing nothing with grown anymore
+
+        std::println("{} - length: {}, capacity: {}", sharing.view(), sharing.length(), sharing.capacity());
+        std::println("{} - length: {}, capacity: {}", grown.view(), grown.length(), grown.capacity());
+        std::println("Shared: {} - {}", sharing.isShared(), grown.isShared());
+    }
+
+    static void test_03()
+    {
+        // allocator-aware: count the heap allocations
+        using CountingSmallString = BasicSmallString<23, CountingAllocator<char>>;
+        using CountingStdString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+
+        for (std::size_t length : { 10, 20, 40 })
+        {
+            std::size_t allocationsStd{};
+            std::size_t allocationsSmall{};
+
+            for (int i{}; i != 1000; ++i) {
+                CountingStdString s1(length, '*', CountingAllocator<char>{ &allocationsStd });
+                CountingSmallString s2{ std::string_view{ s1 }, CountingAllocator<char>{ &allocationsSmall } };
+            }
+
+            std::println("Length {:2}: allocations std::string: {:4} - SmallString: {:4}", length, allocationsStd, allocationsSmall);
+        }
+    }
+
+    // =================================================================================
+    // benchmark: construction, copy and move across length distributions
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumStrings = 100'000;       // debug
+#else
+    static constexpr std::size_t NumStrings = 1'000'000;     // release
+#endif
+
+    static std::vector<std::string> makeInputs(std::size_t minLength, std::size_t maxLength)
+    {
+        std::mt19937 engine{ 42 };
+        std::uniform_int_distribution<std::size_t> lengths{ minLength, maxLength };
+
+        std::vector<std::string> inputs(NumStrings);
+        for (auto& input : inputs) {
+            input.assign(lengths(engine), 'x');
+        }
+
+        return inputs;
+    }
+
+    template <typename TString>
+    static void benchmark(std::string_view label, const std::vector<std::string>& inputs)
+    {
+        std::println("{}:", label);
+
+        std::vector<TString> strings{};
+        strings.reserve(inputs.size());
+
+        std::print("  Construction: ");
+        {
+            ScopedTimer watch{};
+            for (const auto& input : inputs) {
+                strings.emplace_back(std::string_view{ input });
+            }
+        }
+
+        std::print("  Copy:         ");
+        std::vector<TString> copies{};
+        copies.reserve(strings.size());
+        {
+            ScopedTimer watch{};
+            for (const auto& string : strings) {
+                copies.push_back(string);
+            }
+        }
+
+        std::print("  Move:         ");
+        std::vector<TString> moved{};
+        moved.reserve(copies.size());
+        {
+            ScopedTimer watch{};
+            for (auto& string : copies) {
+                moved.push_back(std::move(string));
+            }
+        }
+    }
+
+    static void test_04()
+    {
+        struct Distribution
+        {
+            std::string_view m_name;
+            std::size_t      m_min;
+            std::size_t      m_max;
+        };
+
+        constexpr std::array<Distribution, 4> Distributions
+        {
+            Distribution{ "short (0 - 15)",    0,  15 },
+            Distribution{ "medium (16 - 31)", 16,  31 },
+            Distribution{ "long (32 - 256)",  32, 256 },
+            Distribution{ "mixed (0 - 64)",    0,  64 }
+        };
+
+        for (const auto& distribution : Distributions)
+        {
+            std::println("Lengths {}:", distribution.m_name);
+
+            auto inputs{ makeInputs(distribution.m_min, distribution.m_max) };
+
+            benchmark<std::string>("std::string", inputs);
+            benchmark<SmallString>("SmallString", inputs);
+            benchmark<SmallString31>("SmallString31", inputs);
+            benchmark<CowString>("CowString", inputs);
+            std::println();
+        }
+    }
+}
+
+void main_sso_small_string()
+{
+    using namespace SmallStringOptimization;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,8 @@
 export module modern_cpp:shared_ptr;
 
 export void main_shared_ptr();
+export void main_shared_ptr_local_intrusive();
+export void main_shared_ptr_atomic_publisher();
 
 // =====================================================================================
 // End-of-File
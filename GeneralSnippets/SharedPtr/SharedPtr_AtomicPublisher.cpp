@@ -0,0 +1,391 @@
+// =====================================================================================
+// SharedPtr_AtomicPublisher.cpp // Publishing read-mostly snapshots to many reader threads
+// =====================================================================================
+
+module modern_cpp:shared_ptr;
+
+import std;
+import scoped_timer;
+
+namespace SharedPointerAtomicPublisher {
+
+    // =================================================================================
+    // SnapshotPublisher<T>
+    //
+    // A writer publishes immutable snapshots, many readers load the current one.
+    // Technique: split reference counts. The published word packs the node address
+    // (lower 48 bits) and an "outer" count (upper 16 bits) into one 64-bit atomic:
+    //
+    // - load():    a single fetch_add on the published word, once every 65536 loads
+    //              a second fetch_add on the inner count - wait-free: no loop,
+    //              no CAS, no lock, independent of the writer and of other readers
+    // - release:   a single fetch_sub on the node's "inner" count
+    // - store():   exchanges the published word and transfers the outer count,
+    //              collected so far, to the inner count of the old node
+    //
+    // While a node is published, its inner count carries a large bias, so releases
+    // of readers can't drive it to zero. The bias is removed when the node is replaced;
+    // from then on, the inner count equals the number of readers still holding the node
+    // and the node is deleted when it drops to zero.
+    // The outer count occupies the upper 16 bits: its overflow is carried out of the
+    // 64-bit word, the address is never touched. The reader whose fetch_add wraps the
+    // outer count to 0 adds the 65536 lost references to the inner count.
+    //
+    // Note: requires user space addresses to fit into 48 bits (x64, AArch64),
+    // and less than 65536 snapshots of one value alive at the same time.
+    // =================================================================================
+
+    template <typename T>
+    class SnapshotPublisher
+    {
+    private:
+        struct Node
+        {
+            std::atomic<std::int64_t> m_inner;   // starts with the bias of the publication
+            const T                   m_value;
+
+            template <typename... TArgs>
+            explicit Node(TArgs&&... args) : m_inner{ PublishedBias }, m_value{ std::forward<TArgs>(args)... } {}
+        };
+
+        static constexpr int           PointerBits{ 48 };
+        static constexpr std::uint64_t PointerMask{ (std::uint64_t{ 1 } << PointerBits) - 1 };
+        static constexpr std::uint64_t OuterOne{ std::uint64_t{ 1 } << PointerBits };
+        static constexpr std::int64_t  OuterWrap{ std::int64_t{ 1 } << (64 - PointerBits) };
+        static constexpr std::int64_t  PublishedBias{ std::int64_t{ 1 } << 62 };
+
+        // the outer count ends at the most significant bit: its carry leaves the word
+        static_assert(OuterOne * static_cast<std::uint64_t>(OuterWrap) == 0);
+
+        std::atomic<std::uint64_t> m_published;
+
+        static std::uint64_t pack(Node* node) noexcept {
+            return reinterpret_cast<std::uintptr_t>(node);
+        }
+
+        static Node* nodeOf(std::uint64_t word) noexcept {
+            return reinterpret_cast<Node*>(static_cast<std::uintptr_t>(word & PointerMask));
+        }
+
+        static std::int64_t outerOf(std::uint64_t word) noexcept {
+            return static_cast<std::int64_t>(word >> PointerBits);
+        }
+
+        static void releaseInner(Node* node, std::int64_t count) noexcept {
+            if (node->m_inner.fetch_sub(count, std::memory_order_acq_rel) == count) {
+                delete node;
+            }
+        }
+
+        // old word has been taken out of m_published: transfer its outer count
+        // and remove the bias of the publication
+        static void retire(std::uint64_t word) noexcept {
+            Node* node{ nodeOf(word) };
+            if (node) {
+                releaseInner(node, PublishedBias - outerOf(word));
+            }
+        }
+
+    public:
+        // =============================================================================
+        // Snapshot: RAII handle keeping a published value alive
+        // =============================================================================
+
+        class Snapshot
+        {
+        private:
+            Node* m_node;
+
+            friend class SnapshotPublisher;
+
+            explicit Snapshot(Node* node) noexcept : m_node{ node } {}
+
+        public:
+            Snapshot() noexcept : m_node{} {}
+
+            Snapshot(const Snapshot& other) noexcept : m_node{ other.m_node } {
+                if (m_node) {
+                    m_node->m_inner.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            Snapshot(Snapshot&& other) noexcept : m_node{ std::exchange(other.m_node, nullptr) } {}
+
+            ~Snapshot() {
+                if (m_node) {
+                    releaseInner(m_node, 1);
+                }
+            }
+
+            Snapshot& operator=(Snapshot other) noexcept {
+                std::swap(m_node, other.m_node);
+                return *this;
+            }
+
+            const T& operator*() const noexcept { return m_node->m_value; }
+            const T* operator->() const noexcept { return &m_node->m_value; }
+            const T* get() const noexcept { return m_node ? &m_node->m_value : nullptr; }
+
+            explicit operator bool() const noexcept { return m_node != nullptr; }
+        };
+
+    public:
+        SnapshotPublisher() : m_published{ 0 } {}
+
+        template <typename... TArgs>
+        explicit SnapshotPublisher(std::in_place_t, TArgs&&... args)
+            : m_published{ pack(new Node{ std::forward<TArgs>(args)... }) }
+        {}
+
+        ~SnapshotPublisher() {
+            retire(m_published.load(std::memory_order_acquire));
+        }
+
+        // no copying or moving
+        SnapshotPublisher(const SnapshotPublisher&) = delete;
+        SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+        SnapshotPublisher(SnapshotPublisher&&) noexcept = delete;
+        SnapshotPublisher& operator=(SnapshotPublisher&&) noexcept = delete;
+
+        // reader side
+        Snapshot load() noexcept
+        {
+            const std::uint64_t word{ m_published.fetch_add(OuterOne, std::memory_order_acquire) };
+
+            Node* node{ nodeOf(word) };
+            if (!node) {
+                // nothing published: the outer count of an empty word is never evaluated
+                return Snapshot{};
+            }
+
+            // this increment has wrapped the outer count to 0: the inner count takes over
+            // the lost references - the node is alive, this reader holds one of them
+            if (outerOf(word) == OuterWrap - 1) [[unlikely]] {
+                node->m_inner.fetch_add(OuterWrap, std::memory_order_relaxed);
+            }
+
+            return Snapshot{ node };
+        }
+
+        // writer side
+        template <typename... TArgs>
+        void emplace(TArgs&&... args)
+        {
+            Node* node{ new Node{ std::forward<TArgs>(args)... } };
+            retire(m_published.exchange(pack(node), std::memory_order_acq_rel));
+        }
+
+        void store(T value)
+        {
+            emplace(std::move(value));
+        }
+    };
+
+    // =================================================================================
+    // Configuration snapshots and watchers
+    // (compare with HeavyAndSafeWatcher / LightweightAndSafeWatcher in
+    // Exercises_15_SmartPointers.cpp)
+    // =================================================================================
+
+    struct Configuration
+    {
+        std::size_t m_version;
+        std::string m_server;
+        std::size_t m_port;
+
+        Configuration(std::size_t version, std::string server, std::size_t port)
+            : m_version{ version }, m_server{ std::move(server) }, m_port{ port }
+        {}
+
+#ifdef _DEBUG
+        // a configuration used after its release shows up as a version going backwards
+        ~Configuration() { m_version = 0; }
+#endif
+    };
+
+    // publishes with the lock-free SnapshotPublisher
+    class SnapshotWatcher
+    {
+    private:
+        SnapshotPublisher<Configuration> m_config;
+
+    public:
+        void publish(std::size_t version) {
+            m_config.emplace(version, "server.example.com", 8000 + version % 100);
+        }
+
+        std::size_t currentVersion() {
+            auto snapshot{ m_config.load() };
+            return snapshot ? snapshot->m_version : 0;
+        }
+    };
+
+    // publishes with std::atomic<std::shared_ptr<T>>
+    class AtomicSharedPtrWatcher
+    {
+    private:
+        std::atomic<std::shared_ptr<const Configuration>> m_config;
+
+    public:
+        void publish(std::size_t version) {
+            m_config.store(std::make_shared<const Configuration>(version, "server.example.com", 8000 + version % 100));
+        }
+
+        std::size_t currentVersion() {
+            auto snapshot{ m_config.load() };
+            return snapshot ? snapshot->m_version : 0;
+        }
+    };
+
+    // publishes with a mutex protecting a std::shared_ptr<T>
+    class MutexSharedPtrWatcher
+    {
+    private:
+        std::shared_ptr<const Configuration> m_config;
+        std::mutex                           m_mutex;
+
+    public:
+        void publish(std::size_t version) {
+            auto config{ std::make_shared<const Configuration>(version, "server.example.com", 8000 + version % 100) };
+            std::lock_guard guard{ m_mutex };
+            m_config = std::move(config);
+        }
+
+        std::size_t currentVersion() {
+            std::shared_ptr<const Configuration> snapshot;
+            {
+                std::lock_guard guard{ m_mutex };
+                snapshot = m_config;
+            }
+            return snapshot ? snapshot->m_version : 0;
+        }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        SnapshotPublisher<std::string> publisher{ std::in_place, "Version 1" };
+
+        auto first{ publisher.load() };
+        std::println("First:  {}", *first);
+
+        publisher.store("Version 2");
+
+        // the old snapshot is still valid, new readers see the new value
+        auto second{ publisher.load() };
+        std::println("First:  {}", *first);
+        std::println("Second: {}", *second);
+    }
+
+    // counts the living instances
+    struct Tracked
+    {
+        static inline std::atomic<int> s_alive{ 0 };
+
+        int m_value;
+
+        explicit Tracked(int value) : m_value{ value } { ++s_alive; }
+        ~Tracked() { --s_alive; }
+    };
+
+    static void test_02()
+    {
+        // more than 65536 loads of one value: the outer count wraps several times
+        SnapshotPublisher<Tracked> publisher{ std::in_place, 1 };
+
+        for (int i{}; i != 200'000; ++i) {
+            auto snapshot{ publisher.load() };
+        }
+
+        auto held{ publisher.load() };
+        publisher.emplace(2);
+        std::println("Alive after replacing: {} (expected 2) - held value: {}", Tracked::s_alive.load(), held->m_value);
+
+        held = {};
+        std::println("Alive after releasing: {} (expected 1)", Tracked::s_alive.load());
+    }
+
+    // =================================================================================
+    // benchmark: many readers, one writer
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumReads = 200'000;         // debug, per reader
+#else
+    static constexpr std::size_t NumReads = 5'000'000;       // release, per reader
+#endif
+
+    static constexpr std::array<std::size_t, 4> NumReaders{ 1, 2, 4, 8 };
+
+    template <typename TWatcher>
+    static void benchmark(std::string_view label, std::size_t numReaders)
+    {
+        TWatcher watcher{};
+        watcher.publish(0);
+
+        std::atomic<bool> done{ false };
+        std::atomic<std::size_t> backwards{ 0 };
+
+        std::println("{} - {} reader(s):", label, numReaders);
+
+        std::jthread writer{ [&] {
+            std::size_t version{ 1 };
+            while (!done.load()) {
+                watcher.publish(version++);
+                std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+            }
+        } };
+
+        {
+            ScopedTimer watch{};
+
+            std::vector<std::jthread> readers;
+            for (std::size_t r{}; r != numReaders; ++r) {
+                // the writer publishes increasing versions: a reader must never see
+                // a version older than the one it has seen before
+                readers.emplace_back([&] {
+                    std::size_t localBackwards{};
+                    std::size_t last{};
+                    for (std::size_t i{}; i != NumReads; ++i) {
+                        const std::size_t version{ watcher.currentVersion() };
+                        if (version < last) {
+                            ++localBackwards;
+                        }
+                        last = version;
+                    }
+                    backwards += localBackwards;
+                });
+            }
+        }
+
+        done = true;
+
+        std::println("Versions going backwards: {}", backwards.load());
+    }
+
+    static void test_03()
+    {
+        for (auto numReaders : NumReaders) {
+            benchmark<SnapshotWatcher>("SnapshotPublisher", numReaders);
+            benchmark<AtomicSharedPtrWatcher>("std::atomic<std::shared_ptr>", numReaders);
+            benchmark<MutexSharedPtrWatcher>("std::mutex + std::shared_ptr", numReaders);
+            std::println();
+        }
+    }
+}
+
+void main_shared_ptr_atomic_publisher()
+{
+    using namespace SharedPointerAtomicPublisher;
+    test_01();
+    test_02();
+    test_03();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -0,0 +1,762 @@
+// =====================================================================================
+// SharedPtr_LocalIntrusive.cpp // Non-atomic and intrusive alternatives to std::shared_ptr
+// =====================================================================================
+
+module modern_cpp:shared_ptr;
+
+import std;
+import scoped_timer;
+
+namespace SharedPointerAlternatives {
+
+    // =================================================================================
+    // local_shared_ptr / local_weak_ptr
+    //
+    // Same ownership model as std::shared_ptr / std::weak_ptr, but the reference
+    // counts are plain integers: no atomic instructions when copying.
+    // Note: NOT thread-safe - all copies must live in the same thread.
+    // =================================================================================
+
+    class LocalControlBlock
+    {
+    public:
+        std::size_t m_strong{ 1 };
+        std::size_t m_weak{ 1 };     // all strong references together hold one weak reference
+
+        virtual ~LocalControlBlock() = default;
+
+        virtual void destroyObject() noexcept = 0;
+        virtual void destroyBlock() noexcept = 0;
+
+        void addStrong() noexcept { ++m_strong; }
+        void addWeak() noexcept { ++m_weak; }
+
+        void releaseStrong() noexcept {
+            if (--m_strong == 0) {
+                destroyObject();
+                releaseWeak();
+            }
+        }
+
+        void releaseWeak() noexcept {
+            if (--m_weak == 0) {
+                destroyBlock();
+            }
+        }
+    };
+
+    // control block and object in one allocation (make_local_shared)
+    template <typename T>
+    class LocalControlBlockInplace : public LocalControlBlock
+    {
+    private:
+        alignas(T) unsigned char m_storage[sizeof(T)];
+
+    public:
+        template <typename... TArgs>
+        explicit LocalControlBlockInplace(TArgs&&... args) {
+            std::construct_at(get(), std::forward<TArgs>(args)...);
+        }
+
+        T* get() noexcept { return reinterpret_cast<T*>(m_storage); }
+
+        void destroyObject() noexcept override { std::destroy_at(get()); }
+        void destroyBlock() noexcept override { delete this; }
+    };
+
+    // control block for an object allocated elsewhere
+    template <typename T, typename TDeleter>
+    class LocalControlBlockPointer : public LocalControlBlock
+    {
+    private:
+        T*       m_ptr;
+        TDeleter m_deleter;
+
+    public:
+        LocalControlBlockPointer(T* ptr, TDeleter deleter) : m_ptr{ ptr }, m_deleter{ std::move(deleter) } {}
+
+        void destroyObject() noexcept override { m_deleter(m_ptr); }
+        void destroyBlock() noexcept override { delete this; }
+    };
+
+    template <typename T>
+    class local_weak_ptr;
+
+    template <typename T>
+    class local_shared_ptr
+    {
+    private:
+        T*                 m_ptr;
+        LocalControlBlock* m_block;
+
+        template <typename U> friend class local_shared_ptr;
+        template <typename U> friend class local_weak_ptr;
+
+        template <typename U, typename... TArgs>
+        friend local_shared_ptr<U> make_local_shared(TArgs&&... args);
+
+        // takes over an already counted reference
+        struct AdoptTag {};
+
+        local_shared_ptr(AdoptTag, T* ptr, LocalControlBlock* block) noexcept : m_ptr{ ptr }, m_block{ block } {}
+
+    public:
+        using element_type = T;
+        using weak_type = local_weak_ptr<T>;
+
+        constexpr local_shared_ptr() noexcept : m_ptr{}, m_block{} {}
+        constexpr local_shared_ptr(std::nullptr_t) noexcept : local_shared_ptr{} {}
+
+        template <typename U, typename TDeleter = std::default_delete<U>>
+            requires std::convertible_to<U*, T*>
+        explicit local_shared_ptr(U* ptr, TDeleter deleter = TDeleter{})
+            : m_ptr{ ptr }, m_block{}
+        {
+            try {
+                m_block = new LocalControlBlockPointer<U, TDeleter>{ ptr, deleter };
+            }
+            catch (...) {
+                deleter(ptr);
+                throw;
+            }
+        }
+
+        local_shared_ptr(const local_shared_ptr& other) noexcept
+            : m_ptr{ other.m_ptr }, m_block{ other.m_block }
+        {
+            if (m_block) {
+                m_block->addStrong();
+            }
+        }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_shared_ptr(const local_shared_ptr<U>& other) noexcept
+            : m_ptr{ other.m_ptr }, m_block{ other.m_block }
+        {
+            if (m_block) {
+                m_block->addStrong();
+            }
+        }
+
+        local_shared_ptr(local_shared_ptr&& other) noexcept
+            : m_ptr{ std::exchange(other.m_ptr, nullptr) }, m_block{ std::exchange(other.m_block, nullptr) }
+        {}
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_shared_ptr(local_shared_ptr<U>&& other) noexcept
+            : m_ptr{ std::exchange(other.m_ptr, nullptr) }, m_block{ std::exchange(other.m_block, nullptr) }
+        {}
+
+        ~local_shared_ptr() {
+            if (m_block) {
+                m_block->releaseStrong();
+            }
+        }
+
+        // copy-and-swap covers copy- and move-assignment
+        local_shared_ptr& operator=(local_shared_ptr other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        void swap(local_shared_ptr& other) noexcept {
+            std::swap(m_ptr, other.m_ptr);
+            std::swap(m_block, other.m_block);
+        }
+
+        void reset() noexcept {
+            local_shared_ptr{}.swap(*this);
+        }
+
+        T* get() const noexcept { return m_ptr; }
+        T& operator*() const noexcept { return *m_ptr; }
+        T* operator->() const noexcept { return m_ptr; }
+
+        std::size_t use_count() const noexcept { return m_block ? m_block->m_strong : 0; }
+        explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+        template <typename U>
+        bool operator== (const local_shared_ptr<U>& other) const noexcept { return m_ptr == other.get(); }
+        bool operator== (std::nullptr_t) const noexcept { return m_ptr == nullptr; }
+    };
+
+    template <typename T, typename... TArgs>
+    local_shared_ptr<T> make_local_shared(TArgs&&... args)
+    {
+        auto block{ new LocalControlBlockInplace<T>{ std::forward<TArgs>(args)... } };
+        return local_shared_ptr<T>{ typename local_shared_ptr<T>::AdoptTag{}, block->get(), block };
+    }
+
+    template <typename T>
+    class local_weak_ptr
+    {
+    private:
+        T*                 m_ptr;
+        LocalControlBlock* m_block;
+
+        template <typename U> friend class local_weak_ptr;
+
+    public:
+        constexpr local_weak_ptr() noexcept : m_ptr{}, m_block{} {}
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        local_weak_ptr(const local_shared_ptr<U>& other) noexcept
+            : m_ptr{ other.m_ptr }, m_block{ other.m_block }
+        {
+            if (m_block) {
+                m_block->addWeak();
+            }
+        }
+
+        local_weak_ptr(const local_weak_ptr& other) noexcept
+            : m_ptr{ other.m_ptr }, m_block{ other.m_block }
+        {
+            if (m_block) {
+                m_block->addWeak();
+            }
+        }
+
+        local_weak_ptr(local_weak_ptr&& other) noexcept
+            : m_ptr{ std::exchange(other.m_ptr, nullptr) }, m_block{ std::exchange(other.m_block, nullptr) }
+        {}
+
+        ~local_weak_ptr() {
+            if (m_block) {
+                m_block->releaseWeak();
+            }
+        }
+
+        local_weak_ptr& operator=(local_weak_ptr other) noexcept {
+            std::swap(m_ptr, other.m_ptr);
+            std::swap(m_block, other.m_block);
+            return *this;
+        }
+
+        void reset() noexcept {
+            local_weak_ptr{}.swap(*this);
+        }
+
+        void swap(local_weak_ptr& other) noexcept {
+            std::swap(m_ptr, other.m_ptr);
+            std::swap(m_block, other.m_block);
+        }
+
+        std::size_t use_count() const noexcept { return m_block ? m_block->m_strong : 0; }
+        bool expired() const noexcept { return use_count() == 0; }
+
+        local_shared_ptr<T> lock() const noexcept {
+            if (expired()) {
+                return local_shared_ptr<T>{};
+            }
+            m_block->addStrong();
+            return local_shared_ptr<T>{ typename local_shared_ptr<T>::AdoptTag{}, m_ptr, m_block };
+        }
+    };
+
+    // =================================================================================
+    // intrusive_ptr / intrusive_weak_ptr
+    //
+    // The reference count lives inside the object (base class intrusive_ref_counter),
+    // there is no control block at all. Weak references are supported by a small
+    // "anchor" object, which is allocated only when the first weak reference is created.
+    // Note: NOT thread-safe, too.
+    // =================================================================================
+
+    class WeakAnchor
+    {
+    public:
+        void*         m_object{};    // nullptr once the object is gone
+        std::uint32_t m_count{ 1 };  // the object itself holds one reference
+
+        void addRef() noexcept { ++m_count; }
+
+        void release() noexcept {
+            if (--m_count == 0) {
+                delete this;
+            }
+        }
+    };
+
+    template <typename T>
+    class intrusive_ptr;
+
+    template <typename T>
+    class intrusive_weak_ptr;
+
+    // CRTP base class of all objects managed by intrusive_ptr
+    template <typename TDerived>
+    class intrusive_ref_counter
+    {
+    private:
+        mutable std::uint32_t m_refCount{};
+        mutable WeakAnchor*   m_anchor{};
+
+        template <typename U> friend class intrusive_ptr;
+        template <typename U> friend class intrusive_weak_ptr;
+
+    protected:
+        intrusive_ref_counter() = default;
+
+        // a copied object starts with fresh reference counts
+        intrusive_ref_counter(const intrusive_ref_counter&) noexcept {}
+        intrusive_ref_counter& operator=(const intrusive_ref_counter&) noexcept { return *this; }
+
+        ~intrusive_ref_counter() {
+            if (m_anchor) {
+                m_anchor->release();
+            }
+        }
+
+    private:
+        void addRef() const noexcept { ++m_refCount; }
+
+        void release() const noexcept {
+            if (--m_refCount == 0) {
+                // weak references must not resurrect an object being destroyed
+                if (m_anchor) {
+                    m_anchor->m_object = nullptr;
+                }
+                delete static_cast<const TDerived*>(this);
+            }
+        }
+
+        WeakAnchor* anchor() const {
+            if (!m_anchor) {
+                m_anchor = new WeakAnchor{};
+                m_anchor->m_object = const_cast<TDerived*>(static_cast<const TDerived*>(this));
+            }
+            return m_anchor;
+        }
+
+    public:
+        std::uint32_t use_count() const noexcept { return m_refCount; }
+    };
+
+    template <typename T>
+    class intrusive_ptr
+    {
+    private:
+        T* m_ptr;
+
+        template <typename U> friend class intrusive_ptr;
+
+    public:
+        using element_type = T;
+        using weak_type = intrusive_weak_ptr<T>;
+
+        constexpr intrusive_ptr() noexcept : m_ptr{} {}
+        constexpr intrusive_ptr(std::nullptr_t) noexcept : m_ptr{} {}
+
+        explicit intrusive_ptr(T* ptr) noexcept : m_ptr{ ptr } {
+            if (m_ptr) {
+                m_ptr->addRef();
+            }
+        }
+
+        intrusive_ptr(const intrusive_ptr& other) noexcept : intrusive_ptr{ other.m_ptr } {}
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        intrusive_ptr(const intrusive_ptr<U>& other) noexcept : intrusive_ptr{ other.m_ptr } {}
+
+        intrusive_ptr(intrusive_ptr&& other) noexcept : m_ptr{ std::exchange(other.m_ptr, nullptr) } {}
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        intrusive_ptr(intrusive_ptr<U>&& other) noexcept : m_ptr{ std::exchange(other.m_ptr, nullptr) } {}
+
+        ~intrusive_ptr() {
+            if (m_ptr) {
+                m_ptr->release();
+            }
+        }
+
+        intrusive_ptr& operator=(intrusive_ptr other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        void swap(intrusive_ptr& other) noexcept { std::swap(m_ptr, other.m_ptr); }
+
+        void reset() noexcept { intrusive_ptr{}.swap(*this); }
+
+        T* get() const noexcept { return m_ptr; }
+        T& operator*() const noexcept { return *m_ptr; }
+        T* operator->() const noexcept { return m_ptr; }
+
+        std::size_t use_count() const noexcept { return m_ptr ? m_ptr->use_count() : 0; }
+        explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+        template <typename U>
+        bool operator== (const intrusive_ptr<U>& other) const noexcept { return m_ptr == other.get(); }
+        bool operator== (std::nullptr_t) const noexcept { return m_ptr == nullptr; }
+    };
+
+    template <typename T, typename... TArgs>
+    intrusive_ptr<T> make_intrusive(TArgs&&... args)
+    {
+        return intrusive_ptr<T>{ new T{ std::forward<TArgs>(args)... } };
+    }
+
+    template <typename T>
+    class intrusive_weak_ptr
+    {
+    private:
+        WeakAnchor* m_anchor;
+
+        template <typename U> friend class intrusive_weak_ptr;
+
+    public:
+        constexpr intrusive_weak_ptr() noexcept : m_anchor{} {}
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        intrusive_weak_ptr(const intrusive_ptr<U>& other) : m_anchor{}
+        {
+            if (other) {
+                m_anchor = other->anchor();
+                m_anchor->addRef();
+            }
+        }
+
+        intrusive_weak_ptr(const intrusive_weak_ptr& other) noexcept : m_anchor{ other.m_anchor } {
+            if (m_anchor) {
+                m_anchor->addRef();
+            }
+        }
+
+        intrusive_weak_ptr(intrusive_weak_ptr&& other) noexcept : m_anchor{ std::exchange(other.m_anchor, nullptr) } {}
+
+        ~intrusive_weak_ptr() {
+            if (m_anchor) {
+                m_anchor->release();
+            }
+        }
+
+        intrusive_weak_ptr& operator=(intrusive_weak_ptr other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        void swap(intrusive_weak_ptr& other) noexcept { std::swap(m_anchor, other.m_anchor); }
+
+        void reset() noexcept { intrusive_weak_ptr{}.swap(*this); }
+
+        bool expired() const noexcept { return !m_anchor || !m_anchor->m_object; }
+
+        intrusive_ptr<T> lock() const noexcept {
+            if (expired()) {
+                return intrusive_ptr<T>{};
+            }
+            return intrusive_ptr<T>{ static_cast<std::remove_cv_t<T>*>(m_anchor->m_object) };
+        }
+    };
+
+    // =================================================================================
+    // Mom and Child (see Exercises_15_SmartPointers.cpp, Exercise_06)
+    // rewritten with local_shared_ptr / local_weak_ptr
+    // =================================================================================
+
+    namespace LocalMomAndChild {
+
+        class Child;
+
+        class Mom {
+        private:
+            std::string m_name;
+            local_weak_ptr<const Child> m_child;
+
+        public:
+            explicit Mom(std::string name) : m_name(std::move(name)) {}
+
+            ~Mom() {
+                std::println("Mother ({}) passes away.", m_name);
+            }
+
+            const std::string& getName() const { return m_name; }
+
+            void setChild(const local_shared_ptr<Child>& child) { m_child = child; }
+
+            void sayHello() const;
+        };
+
+        class Child {
+        private:
+            std::string m_name;
+            local_weak_ptr<const Mom> m_mother;
+
+        public:
+            explicit Child(std::string name) : m_name(std::move(name)) {}
+
+            ~Child() {
+                std::println("Child ({}) passes away.", m_name);
+            }
+
+            const std::string& getName() const { return m_name; }
+
+            void setMother(const local_shared_ptr<Mom>& mother) { m_mother = mother; }
+
+            void sayHello() const {
+                if (auto mother = m_mother.lock()) {
+                    std::println("{}: Hello mother.", m_name);
+                }
+                else {
+                    std::println("{}: My mother no longer exists.", m_name);
+                }
+            }
+        };
+
+        void Mom::sayHello() const {
+            if (auto child = m_child.lock()) {
+                std::println("{}: Hello child.", m_name);
+            }
+            else {
+                std::println("{}: My child no longer exists.", m_name);
+            }
+        }
+    }
+
+    // =================================================================================
+    // Mom and Child rewritten with intrusive_ptr / intrusive_weak_ptr
+    // =================================================================================
+
+    namespace IntrusiveMomAndChild {
+
+        class Child;
+
+        class Mom : public intrusive_ref_counter<Mom> {
+        private:
+            std::string m_name;
+            intrusive_weak_ptr<const Child> m_child;
+
+        public:
+            explicit Mom(std::string name) : m_name(std::move(name)) {}
+
+            ~Mom() {
+                std::println("Mother ({}) passes away.", m_name);
+            }
+
+            const std::string& getName() const { return m_name; }
+
+            void setChild(const intrusive_ptr<Child>& child) { m_child = child; }
+
+            void sayHello() const;
+        };
+
+        class Child : public intrusive_ref_counter<Child> {
+        private:
+            std::string m_name;
+            intrusive_weak_ptr<const Mom> m_mother;
+
+        public:
+            explicit Child(std::string name) : m_name(std::move(name)) {}
+
+            ~Child() {
+                std::println("Child ({}) passes away.", m_name);
+            }
+
+            const std::string& getName() const { return m_name; }
+
+            void setMother(const intrusive_ptr<Mom>& mother) { m_mother = mother; }
+
+            void sayHello() const {
+                if (auto mother = m_mother.lock()) {
+                    std::println("{}: Hello mother.", m_name);
+                }
+                else {
+                    std::println("{}: My mother no longer exists.", m_name);
+                }
+            }
+        };
+
+        void Mom::sayHello() const {
+            if (auto child = m_child.lock()) {
+                std::println("{}: Hello child.", m_name);
+            }
+            else {
+                std::println("{}: My child no longer exists.", m_name);
+            }
+        }
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void storeLocalSharedPointer(local_shared_ptr<int> ptr)
+    {
+        std::println("Inner scope: {}", ptr.use_count());
+    }
+
+    static void test_01()
+    {
+        // compare with test_02 in SharedPtr.cpp
+        local_shared_ptr<int> ptr{ make_local_shared<int>(123) };
+        std::println("Outer scope: {}", ptr.use_count());
+
+        storeLocalSharedPointer(ptr);
+        std::println("Outer scope: {}", ptr.use_count());
+
+        local_shared_ptr<std::string> sp{ new std::string{ "ABC" } };
+        local_weak_ptr<std::string> wp{ sp };
+        std::println("Value: {}, expired: {}", *wp.lock(), wp.expired());
+        sp.reset();
+        std::println("expired: {}", wp.expired());
+    }
+
+    template <typename TMom, typename TChild, typename TFactory>
+    static void testMomAndChild(TFactory factory)
+    {
+        auto mother{ factory(std::type_identity<TMom>{}, "Dorothea") };
+        auto child{ factory(std::type_identity<TChild>{}, "John") };
+
+        mother->setChild(child);
+        child->setMother(mother);
+
+        std::println("{}: use_count = {}", mother->getName(), mother.use_count());
+        std::println("{}: use_count = {}", child->getName(), child.use_count());
+
+        mother->sayHello();
+        child->sayHello();
+
+        mother.reset();
+        child->sayHello();
+    }
+
+    static void test_02()
+    {
+        std::println("local_shared_ptr:");
+        testMomAndChild<LocalMomAndChild::Mom, LocalMomAndChild::Child>(
+            []<typename T>(std::type_identity<T>, const char* name) { return make_local_shared<T>(name); }
+        );
+
+        std::println("intrusive_ptr:");
+        testMomAndChild<IntrusiveMomAndChild::Mom, IntrusiveMomAndChild::Child>(
+            []<typename T>(std::type_identity<T>, const char* name) { return make_intrusive<T>(name); }
+        );
+    }
+
+    // =================================================================================
+    // benchmark: copy-heavy traversal of a tree
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumNodes = 100'000;       // debug
+    static constexpr std::size_t NumTraversals = 5;        // debug
+#else
+    static constexpr std::size_t NumNodes = 1'000'000;     // release
+    static constexpr std::size_t NumTraversals = 20;       // release
+#endif
+
+    static constexpr std::size_t NumChildren = 4;
+
+    // the base class is needed for the intrusive_ptr variant only
+    template <template <typename> typename TPtr>
+    class Node : public intrusive_ref_counter<Node<TPtr>>
+    {
+    public:
+        std::size_t m_value;
+        std::vector<TPtr<Node>> m_children;
+
+        explicit Node(std::size_t value) : m_value{ value } {}
+    };
+
+    template <template <typename> typename TPtr, typename TFactory>
+    static TPtr<Node<TPtr>> buildTree(TFactory factory)
+    {
+        using NodePtr = TPtr<Node<TPtr>>;
+
+        std::vector<NodePtr> nodes;
+        nodes.reserve(NumNodes);
+
+        for (std::size_t i{}; i != NumNodes; ++i) {
+            nodes.push_back(factory(i));
+        }
+
+        for (std::size_t i{ 1 }; i != NumNodes; ++i) {
+            nodes[(i - 1) / NumChildren]->m_children.push_back(nodes[i]);
+        }
+
+        return nodes[0];
+    }
+
+    // pointers are copied onto the stack and out of it again: one increment/decrement each
+    template <typename TNodePtr>
+    static std::size_t traverse(TNodePtr root)
+    {
+        std::size_t sum{};
+
+        std::vector<TNodePtr> stack{ root };
+
+        while (!stack.empty()) {
+            TNodePtr node{ stack.back() };
+            stack.pop_back();
+
+            sum += node->m_value;
+
+            for (const auto& child : node->m_children) {
+                stack.push_back(child);
+            }
+        }
+
+        return sum;
+    }
+
+    template <template <typename> typename TPtr, typename TFactory>
+    static void benchmark(std::string_view label, TFactory factory)
+    {
+        std::println("{}", label);
+
+        auto root{ buildTree<TPtr>(factory) };
+
+        std::size_t sum{};
+        {
+            ScopedTimer watch{};
+
+            for (std::size_t i{}; i != NumTraversals; ++i) {
+                sum += traverse(root);
+            }
+        }
+
+        std::println("Sum: {}", sum);
+    }
+
+    template <typename T>
+    using SharedPtr = std::shared_ptr<T>;
+
+    template <typename T>
+    using LocalSharedPtr = local_shared_ptr<T>;
+
+    template <typename T>
+    using IntrusivePtr = intrusive_ptr<T>;
+
+    static void test_03()
+    {
+        benchmark<SharedPtr>("std::shared_ptr:",
+            [](std::size_t i) { return std::make_shared<Node<SharedPtr>>(i); }
+        );
+
+        benchmark<LocalSharedPtr>("local_shared_ptr:",
+            [](std::size_t i) { return make_local_shared<Node<LocalSharedPtr>>(i); }
+        );
+
+        benchmark<IntrusivePtr>("intrusive_ptr:",
+            [](std::size_t i) { return make_intrusive<Node<IntrusivePtr>>(i); }
+        );
+    }
+}
+
+void main_shared_ptr_local_intrusive()
+{
+    using namespace SharedPointerAlternatives;
+    test_01();
+    test_02();
+    test_03();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,7 @@
 export module modern_cpp:string_view;
 
 export void main_string_view();
+export void main_string_view_scanning();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,441 @@
+// =====================================================================================
+// StringView_Scanning.cpp // Text scanning primitives for std::string_view (SSE2 / AVX2)
+// =====================================================================================
+
+module;
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define STRING_SCANNING_SSE2
+#if defined(__AVX2__)
+#define STRING_SCANNING_AVX2
+#endif
+#endif
+
+module modern_cpp:string_view;
+
+import std;
+import scoped_timer;
+
+namespace StringViewScanning {
+
+    // =================================================================================
+    // Character classes - ASCII only, independent of the current locale
+    // =================================================================================
+
+    enum class CharClass { Upper, Lower, Digit, Space, Alpha, AlNum };
+
+    struct ByteRange
+    {
+        unsigned char m_low;
+        unsigned char m_high;
+    };
+
+    // every class is described by at most three contiguous byte ranges
+    struct ByteRanges
+    {
+        std::array<ByteRange, 3> m_ranges;
+        std::size_t              m_count;
+    };
+
+    static constexpr ByteRanges rangesOf(CharClass cc)
+    {
+        switch (cc)
+        {
+        case CharClass::Upper: return { { { { 'A', 'Z' } } }, 1 };
+        case CharClass::Lower: return { { { { 'a', 'z' } } }, 1 };
+        case CharClass::Digit: return { { { { '0', '9' } } }, 1 };
+        case CharClass::Space: return { { { { '\t', '\r' }, { ' ', ' ' } } }, 2 };
+        case CharClass::Alpha: return { { { { 'A', 'Z' }, { 'a', 'z' } } }, 2 };
+        case CharClass::AlNum: return { { { { 'A', 'Z' }, { 'a', 'z' }, { '0', '9' } } }, 3 };
+        }
+        return { {}, 0 };
+    }
+
+    static constexpr bool isInClass(CharClass cc, char ch)
+    {
+        const ByteRanges ranges{ rangesOf(cc) };
+        const auto uc{ static_cast<unsigned char>(ch) };
+
+        for (std::size_t i{}; i != ranges.m_count; ++i) {
+            // single unsigned comparison per range: (uc - low) <= (high - low)
+            if (static_cast<unsigned char>(uc - ranges.m_ranges[i].m_low) <=
+                static_cast<unsigned char>(ranges.m_ranges[i].m_high - ranges.m_ranges[i].m_low)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static_assert(isInClass(CharClass::Upper, 'Q'));
+    static_assert(!isInClass(CharClass::Upper, 'q'));
+    static_assert(isInClass(CharClass::Space, '\n'));
+    static_assert(isInClass(CharClass::AlNum, '7'));
+    static_assert(!isInClass(CharClass::Digit, '\xB9'));
+
+    // =================================================================================
+    // Scalar kernels (fallback and tail processing)
+    // =================================================================================
+
+    static std::size_t countIfClassScalar(std::string_view sv, CharClass cc)
+    {
+        std::size_t result{};
+        for (char ch : sv) {
+            result += isInClass(cc, ch) ? 1 : 0;
+        }
+        return result;
+    }
+
+    static std::size_t findFirstOfScalar(std::string_view sv, std::string_view set, std::size_t pos = 0)
+    {
+        std::array<bool, 256> table{};
+        for (char ch : set) {
+            table[static_cast<unsigned char>(ch)] = true;
+        }
+
+        for (std::size_t i{ pos }; i < sv.size(); ++i) {
+            if (table[static_cast<unsigned char>(sv[i])]) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    // =================================================================================
+    // SIMD kernels
+    //
+    // Range test per byte: adding (0x80 - low) maps [low, high] onto
+    // [-128, -128 + (high - low)], so one signed comparison per range suffices.
+    // =================================================================================
+
+#if defined(STRING_SCANNING_SSE2)
+
+    static __m128i classMask128(__m128i chunk, const ByteRanges& ranges)
+    {
+        __m128i mask{ _mm_setzero_si128() };
+
+        for (std::size_t i{}; i != ranges.m_count; ++i) {
+            const auto low{ ranges.m_ranges[i].m_low };
+            const auto width{ ranges.m_ranges[i].m_high - low };
+
+            const __m128i bias{ _mm_set1_epi8(static_cast<char>(0x80 - low)) };
+            const __m128i limit{ _mm_set1_epi8(static_cast<char>(0x80 + width + 1)) };
+            const __m128i shifted{ _mm_add_epi8(chunk, bias) };
+
+            mask = _mm_or_si128(mask, _mm_cmplt_epi8(shifted, limit));
+        }
+
+        return mask;
+    }
+
+    static std::size_t countIfClassSSE2(std::string_view sv, CharClass cc)
+    {
+        const ByteRanges ranges{ rangesOf(cc) };
+        const char* data{ sv.data() };
+        const std::size_t size{ sv.size() };
+
+        std::size_t result{};
+        std::size_t i{};
+
+        for (; i + 16 <= size; i += 16) {
+            const __m128i chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)) };
+            const int bits{ _mm_movemask_epi8(classMask128(chunk, ranges)) };
+            result += std::popcount(static_cast<unsigned int>(bits));
+        }
+
+        return result + countIfClassScalar(sv.substr(i), cc);
+    }
+
+    static std::size_t findFirstOfSSE2(std::string_view sv, std::string_view set, std::size_t pos)
+    {
+        const char* data{ sv.data() };
+        const std::size_t size{ sv.size() };
+
+        std::size_t i{ pos };
+
+        for (; i + 16 <= size; i += 16) {
+            const __m128i chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)) };
+
+            __m128i mask{ _mm_setzero_si128() };
+            for (char ch : set) {
+                mask = _mm_or_si128(mask, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(ch)));
+            }
+
+            const int bits{ _mm_movemask_epi8(mask) };
+            if (bits != 0) {
+                return i + std::countr_zero(static_cast<unsigned int>(bits));
+            }
+        }
+
+        return findFirstOfScalar(sv, set, i);
+    }
+
+#endif
+
+#if defined(STRING_SCANNING_AVX2)
+
+    static __m256i classMask256(__m256i chunk, const ByteRanges& ranges)
+    {
+        __m256i mask{ _mm256_setzero_si256() };
+
+        for (std::size_t i{}; i != ranges.m_count; ++i) {
+            const auto low{ ranges.m_ranges[i].m_low };
+            const auto width{ ranges.m_ranges[i].m_high - low };
+
+            const __m256i bias{ _mm256_set1_epi8(static_cast<char>(0x80 - low)) };
+            const __m256i limit{ _mm256_set1_epi8(static_cast<char>(0x80 + width + 1)) };
+            const __m256i shifted{ _mm256_add_epi8(chunk, bias) };
+
+            mask = _mm256_or_si256(mask, _mm256_cmpgt_epi8(limit, shifted));
+        }
+
+        return mask;
+    }
+
+    static std::size_t countIfClassAVX2(std::string_view sv, CharClass cc)
+    {
+        const ByteRanges ranges{ rangesOf(cc) };
+        const char* data{ sv.data() };
+        const std::size_t size{ sv.size() };
+
+        std::size_t result{};
+        std::size_t i{};
+
+        for (; i + 32 <= size; i += 32) {
+            const __m256i chunk{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)) };
+            const int bits{ _mm256_movemask_epi8(classMask256(chunk, ranges)) };
+            result += std::popcount(static_cast<unsigned int>(bits));
+        }
+
+        return result + countIfClassSSE2(sv.substr(i), cc);
+    }
+
+    static std::size_t findFirstOfAVX2(std::string_view sv, std::string_view set, std::size_t pos)
+    {
+        const char* data{ sv.data() };
+        const std::size_t size{ sv.size() };
+
+        std::size_t i{ pos };
+
+        for (; i + 32 <= size; i += 32) {
+            const __m256i chunk{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)) };
+
+            __m256i mask{ _mm256_setzero_si256() };
+            for (char ch : set) {
+                mask = _mm256_or_si256(mask, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(ch)));
+            }
+
+            const int bits{ _mm256_movemask_epi8(mask) };
+            if (bits != 0) {
+                return i + std::countr_zero(static_cast<unsigned int>(bits));
+            }
+        }
+
+        return findFirstOfSSE2(sv, set, i);
+    }
+
+#endif
+
+    // =================================================================================
+    // Public interface - selects the widest kernel available at compile time
+    // =================================================================================
+
+    // sets with more characters than this are searched with a lookup table
+    static constexpr std::size_t MaxSimdSetSize = 8;
+
+    static std::size_t countIfClass(std::string_view sv, CharClass cc)
+    {
+#if defined(STRING_SCANNING_AVX2)
+        return countIfClassAVX2(sv, cc);
+#elif defined(STRING_SCANNING_SSE2)
+        return countIfClassSSE2(sv, cc);
+#else
+        return countIfClassScalar(sv, cc);
+#endif
+    }
+
+    static std::size_t findFirstOf(std::string_view sv, std::string_view set, std::size_t pos = 0)
+    {
+        if (pos >= sv.size() || set.empty()) {
+            return std::string_view::npos;
+        }
+
+        if (set.size() > MaxSimdSetSize) {
+            return findFirstOfScalar(sv, set, pos);
+        }
+
+#if defined(STRING_SCANNING_AVX2)
+        return findFirstOfAVX2(sv, set, pos);
+#elif defined(STRING_SCANNING_SSE2)
+        return findFirstOfSSE2(sv, set, pos);
+#else
+        return findFirstOfScalar(sv, set, pos);
+#endif
+    }
+
+    // splits by a single-byte delimiter, the result vector is reused by the caller
+    static std::size_t split(std::string_view sv, char delimiter, std::vector<std::string_view>& parts)
+    {
+        parts.clear();
+
+        const std::string_view set{ &delimiter, 1 };
+
+        std::size_t start{};
+        while (true) {
+            const std::size_t pos{ findFirstOf(sv, set, start) };
+            if (pos == std::string_view::npos) {
+                parts.push_back(sv.substr(start));
+                break;
+            }
+
+            parts.push_back(sv.substr(start, pos - start));
+            start = pos + 1;
+        }
+
+        return parts.size();
+    }
+
+    // only touches the leading and trailing characters, so a scalar loop suffices
+    static std::string_view trim(std::string_view sv)
+    {
+        std::size_t first{};
+        while (first != sv.size() && isInClass(CharClass::Space, sv[first])) {
+            ++first;
+        }
+
+        std::size_t last{ sv.size() };
+        while (last != first && isInClass(CharClass::Space, sv[last - 1])) {
+            --last;
+        }
+
+        return sv.substr(first, last - first);
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        std::string_view sv{ "DiesIstEinLangerSatzMitVielenGrossbuchstaben 1234 56789" };
+
+        std::println("Upper:  {}", countIfClass(sv, CharClass::Upper));
+        std::println("Lower:  {}", countIfClass(sv, CharClass::Lower));
+        std::println("Digit:  {}", countIfClass(sv, CharClass::Digit));
+        std::println("Space:  {}", countIfClass(sv, CharClass::Space));
+        std::println("Alpha:  {}", countIfClass(sv, CharClass::Alpha));
+        std::println("AlNum:  {}", countIfClass(sv, CharClass::AlNum));
+    }
+
+    static void test_02()
+    {
+        std::string_view sv{ "key_without_any_separator_so_far=value;next" };
+
+        std::println("findFirstOf(\"=;\"): {}", findFirstOf(sv, "=;"));
+        std::println("find_first_of:     {}", sv.find_first_of("=;"));
+        std::println("findFirstOf(\"#\"):  {}", findFirstOf(sv, "#") == std::string_view::npos);
+    }
+
+    static void test_03()
+    {
+        std::vector<std::string_view> parts;
+
+        split("Hans,Sepp,,Georg,Anton,Maximilian,Franziska,Elisabeth,", ',', parts);
+
+        for (std::size_t i{}; auto part : parts) {
+            std::println("{}: [{}]", i, part);
+            ++i;
+        }
+
+        // vector is reused - no further allocations as long as its capacity suffices
+        split("A;B;C", ';', parts);
+        std::println("Parts: {}", parts.size());
+    }
+
+    static void test_04()
+    {
+        std::println("[{}]", trim("  \t Hello World \r\n"));
+        std::println("[{}]", trim("   "));
+        std::println("[{}]", trim("NoSpaces"));
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t TextSize = 10'000'000;       // debug
+#else
+    static constexpr std::size_t TextSize = 200'000'000;      // release
+#endif
+
+    // original implementation of StringView.cpp
+    static std::size_t countUpperCaseChars(std::string_view sv) {
+
+        std::size_t result{};
+
+        for (char c : sv) {
+            if (std::isupper(c)) {
+                ++result;
+            }
+        }
+
+        return result;
+    }
+
+    static void test_05()
+    {
+        std::string text(TextSize, ' ');
+
+        std::mt19937 generator{ 1 };
+        std::uniform_int_distribution<int> distribution{ 32, 126 };
+        for (auto& ch : text) {
+            ch = static_cast<char>(distribution(generator));
+        }
+
+        std::size_t count{};
+
+        std::println("countUpperCaseChars (std::isupper):");
+        {
+            ScopedTimer watch{};
+            count = countUpperCaseChars(text);
+        }
+        std::println("Result: {}", count);
+
+        std::println("countIfClass (scalar):");
+        {
+            ScopedTimer watch{};
+            count = countIfClassScalar(text, CharClass::Upper);
+        }
+        std::println("Result: {}", count);
+
+        std::println("countIfClass (SIMD):");
+        {
+            ScopedTimer watch{};
+            count = countIfClass(text, CharClass::Upper);
+        }
+        std::println("Result: {}", count);
+
+        std::vector<std::string_view> parts;
+        std::println("split (SIMD):");
+        {
+            ScopedTimer watch{};
+            count = split(text, '~', parts);
+        }
+        std::println("Parts: {}", count);
+    }
+}
+
+void main_string_view_scanning()
+{
+    using namespace StringViewScanning;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+    test_05();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
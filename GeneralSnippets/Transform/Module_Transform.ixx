@@ -5,6 +5,8 @@
 export module modern_cpp:transform;
 
 export void main_transform();
+export void main_transform_string_interning();
+export void main_transform_views();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,491 @@
+// =====================================================================================
+// Transform_StringInterning.cpp // String interning pool and compact string handles
+// =====================================================================================
+
+module modern_cpp:transform;
+
+import std;
+import scoped_timer;
+
+namespace StringInterning {
+
+    // =================================================================================
+    // InternedString: 32-bit handle into a StringPool
+    // Two handles of the same pool are equal if and only if the strings are equal.
+    // =================================================================================
+
+    class InternedString
+    {
+    private:
+        std::uint32_t m_id;
+
+    public:
+        constexpr InternedString() noexcept : m_id{ Invalid } {}
+        constexpr explicit InternedString(std::uint32_t id) noexcept : m_id{ id } {}
+
+        constexpr std::uint32_t id() const noexcept { return m_id; }
+        constexpr bool isValid() const noexcept { return m_id != Invalid; }
+
+        constexpr bool operator== (const InternedString&) const noexcept = default;
+        constexpr auto operator<=> (const InternedString&) const noexcept = default;
+
+        static constexpr std::uint32_t Invalid{ std::numeric_limits<std::uint32_t>::max() };
+    };
+
+    static_assert(sizeof(InternedString) == 4);
+
+    // hash functor for unordered containers keyed by handles
+    struct InternedStringHash
+    {
+        std::size_t operator()(InternedString handle) const noexcept {
+            // ids are dense and unique, a multiplicative hash spreads them sufficiently
+            return static_cast<std::size_t>(handle.id()) * 0x9E3779B97F4A7C15ull;
+        }
+    };
+
+    // =================================================================================
+    // StringPool
+    //
+    // - characters are stored back-to-back in an arena of large chunks,
+    //   so interning a string costs no allocation most of the time
+    // - every string is stored once, its hash value is computed once
+    // - intern() may be called concurrently from several threads
+    // - after freeze() the pool is read-only, all lookups proceed without locking
+    // =================================================================================
+
+    class StringPool
+    {
+    private:
+        struct Entry
+        {
+            const char*   m_data;
+            std::uint32_t m_length;
+            std::size_t   m_hash;
+        };
+
+        // transparent hashing: lookups with std::string_view don't create a std::string
+        struct ViewHash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view sv) const noexcept {
+                return std::hash<std::string_view>{}(sv);
+            }
+        };
+
+        static constexpr std::size_t ChunkSize{ 64 * 1024 };
+
+        std::vector<std::unique_ptr<char[]>>   m_chunks;
+        char*                                  m_current;
+        std::size_t                            m_chunkUsed;
+        std::size_t                            m_bytes;
+        std::vector<Entry>                     m_entries;
+        std::unordered_map<std::string_view, std::uint32_t, ViewHash, std::equal_to<>> m_index;
+
+        mutable std::shared_mutex m_mutex;
+        std::atomic<bool>         m_frozen;
+
+    public:
+        StringPool() : m_current{}, m_chunkUsed{}, m_bytes{}, m_frozen{ false } {}
+
+        // no copying or moving - handles refer to this very pool
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        StringPool(StringPool&&) noexcept = delete;
+        StringPool& operator=(StringPool&&) noexcept = delete;
+
+        InternedString intern(std::string_view sv)
+        {
+            if (m_frozen.load(std::memory_order_acquire)) {
+
+                auto pos{ m_index.find(sv) };
+                if (pos == m_index.end()) {
+                    throw std::logic_error{ "StringPool: pool is frozen" };
+                }
+                return InternedString{ pos->second };
+            }
+
+            // fast path: string is already known
+            {
+                std::shared_lock guard{ m_mutex };
+
+                auto pos{ m_index.find(sv) };
+                if (pos != m_index.end()) {
+                    return InternedString{ pos->second };
+                }
+            }
+
+            // slow path: insert, the string might have been added meanwhile
+            std::unique_lock guard{ m_mutex };
+
+            auto pos{ m_index.find(sv) };
+            if (pos != m_index.end()) {
+                return InternedString{ pos->second };
+            }
+
+            // freeze() might have been called meanwhile: frozen readers don't lock anymore
+            if (m_frozen.load(std::memory_order_relaxed)) {
+                throw std::logic_error{ "StringPool: pool is frozen" };
+            }
+
+            if (m_entries.size() >= InternedString::Invalid) {
+                throw std::length_error{ "StringPool: too many strings" };
+            }
+
+            if (sv.size() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error{ "StringPool: string too long" };
+            }
+
+            const char* data{ store(sv) };
+            const auto id{ static_cast<std::uint32_t>(m_entries.size()) };
+
+            m_entries.push_back({ data, static_cast<std::uint32_t>(sv.size()), ViewHash{}(sv) });
+            m_index.emplace(std::string_view{ data, sv.size() }, id);
+
+            return InternedString{ id };
+        }
+
+        std::optional<InternedString> find(std::string_view sv) const
+        {
+            std::shared_lock guard{ m_mutex, std::defer_lock };
+            if (!m_frozen.load(std::memory_order_acquire)) {
+                guard.lock();
+            }
+
+            auto pos{ m_index.find(sv) };
+            if (pos == m_index.end()) {
+                return std::nullopt;
+            }
+            return InternedString{ pos->second };
+        }
+
+        std::string_view view(InternedString handle) const
+        {
+            const Entry entry{ lookup(handle) };
+            return std::string_view{ entry.m_data, entry.m_length };
+        }
+
+        std::size_t hash(InternedString handle) const
+        {
+            return lookup(handle).m_hash;
+        }
+
+        // switches to read-only mode: no further strings, no further locking
+        void freeze()
+        {
+            std::unique_lock guard{ m_mutex };
+            m_frozen.store(true, std::memory_order_release);
+        }
+
+        bool isFrozen() const noexcept
+        {
+            return m_frozen.load(std::memory_order_acquire);
+        }
+
+        std::size_t size() const
+        {
+            std::shared_lock guard{ m_mutex };
+            return m_entries.size();
+        }
+
+        // characters stored in the arena
+        std::size_t bytes() const
+        {
+            std::shared_lock guard{ m_mutex };
+            return m_bytes;
+        }
+
+    private:
+        Entry lookup(InternedString handle) const
+        {
+            std::shared_lock guard{ m_mutex, std::defer_lock };
+            if (!m_frozen.load(std::memory_order_acquire)) {
+                guard.lock();
+            }
+
+            if (handle.id() >= m_entries.size()) {
+                throw std::out_of_range{ "StringPool: invalid handle" };
+            }
+            return m_entries[handle.id()];
+        }
+
+        // copies the characters into the arena - caller holds the exclusive lock
+        const char* store(std::string_view sv)
+        {
+            m_bytes += sv.size();
+
+            // large strings get a chunk of their own, the current chunk stays active
+            if (sv.size() > ChunkSize / 4) {
+                auto chunk{ std::make_unique_for_overwrite<char[]>(sv.size()) };
+                std::copy(sv.begin(), sv.end(), chunk.get());
+                m_chunks.push_back(std::move(chunk));
+                return m_chunks.back().get();
+            }
+
+            if (m_current == nullptr || m_chunkUsed + sv.size() > ChunkSize) {
+                m_chunks.push_back(std::make_unique_for_overwrite<char[]>(ChunkSize));
+                m_current = m_chunks.back().get();
+                m_chunkUsed = 0;
+            }
+
+            char* dest{ m_current + m_chunkUsed };
+            std::copy(sv.begin(), sv.end(), dest);
+            m_chunkUsed += sv.size();
+            return dest;
+        }
+    };
+
+    // =================================================================================
+    // Phonebook using interned names
+    // (compare with PhoneBookVector in Exercises_03_STL.cpp)
+    // =================================================================================
+
+    class PhoneBookInterned
+    {
+    private:
+        using Entry = std::tuple<InternedString, InternedString, std::size_t>;
+
+        StringPool&        m_pool;
+        std::vector<Entry> m_entries;
+
+    public:
+        explicit PhoneBookInterned(StringPool& pool) : m_pool{ pool } {}
+
+        std::size_t size() const { return m_entries.size(); }
+
+        void insert(std::string_view first, std::string_view last, std::size_t number)
+        {
+            m_entries.emplace_back(m_pool.intern(first), m_pool.intern(last), number);
+        }
+
+        std::optional<std::size_t> search(std::string_view first, std::string_view last) const
+        {
+            // unknown names can't be part of the phonebook
+            const auto handleFirst{ m_pool.find(first) };
+            const auto handleLast{ m_pool.find(last) };
+            if (!handleFirst || !handleLast) {
+                return std::nullopt;
+            }
+
+            // integer compares only
+            auto pos = std::find_if(
+                m_entries.begin(),
+                m_entries.end(),
+                [&](const auto& entry) {
+                    const auto& [_first, _last, _number] = entry;
+                    return _first == *handleFirst and _last == *handleLast;
+                }
+            );
+
+            if (pos == m_entries.end()) {
+                return std::nullopt;
+            }
+            return std::get<2>(*pos);
+        }
+
+        void print() const
+        {
+            for (const auto& [first, last, number] : m_entries) {
+                std::println("{} {}: {}", m_pool.view(first), m_pool.view(last), number);
+            }
+        }
+
+        // memory used by the entries themselves (the pool is shared)
+        std::size_t bytes() const
+        {
+            return m_entries.capacity() * sizeof(Entry);
+        }
+    };
+
+    class PhoneBookStrings
+    {
+    private:
+        using Entry = std::tuple<std::string, std::string, std::size_t>;
+
+        std::vector<Entry> m_entries;
+
+    public:
+        void insert(std::string_view first, std::string_view last, std::size_t number)
+        {
+            m_entries.emplace_back(std::string{ first }, std::string{ last }, number);
+        }
+
+        std::optional<std::size_t> search(std::string_view first, std::string_view last) const
+        {
+            auto pos = std::find_if(
+                m_entries.begin(),
+                m_entries.end(),
+                [&](const auto& entry) {
+                    const auto& [_first, _last, _number] = entry;
+                    return _first == first and _last == last;
+                }
+            );
+
+            if (pos == m_entries.end()) {
+                return std::nullopt;
+            }
+            return std::get<2>(*pos);
+        }
+
+        // approximation: entries plus heap blocks of strings exceeding the SSO buffer
+        std::size_t bytes() const
+        {
+            const std::size_t sso{ std::string{}.capacity() };
+
+            std::size_t bytes{ m_entries.capacity() * sizeof(Entry) };
+            for (const auto& [first, last, number] : m_entries) {
+                bytes += (first.capacity() > sso) ? first.capacity() + 1 : 0;
+                bytes += (last.capacity() > sso) ? last.capacity() + 1 : 0;
+            }
+            return bytes;
+        }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        StringPool pool{};
+
+        InternedString hans1{ pool.intern("Hans") };
+        InternedString meier{ pool.intern("Meier") };
+        InternedString hans2{ pool.intern(std::string{ "Hans" }) };
+
+        std::println("hans1 == hans2: {}", hans1 == hans2);
+        std::println("hans1 == meier: {}", hans1 == meier);
+        std::println("view(hans1):    {}", pool.view(hans1));
+        std::println("hash(meier):    {}", pool.hash(meier));
+        std::println("Strings: {}, Bytes: {}", pool.size(), pool.bytes());
+
+        std::unordered_set<InternedString, InternedStringHash> set{ hans1, meier, hans2 };
+        std::println("Distinct names: {}", set.size());
+    }
+
+    static void test_02()
+    {
+        StringPool pool{};
+        PhoneBookInterned book{ pool };
+
+        book.insert("Franz", "Schneider", 8483);
+        book.insert("Hans", "Mueller", 5326);
+        book.insert("Sepp", "Meier", 7561);
+        book.insert("Hans", "Meier", 4899);
+        book.print();
+
+        auto number{ book.search("Hans", "Meier") };
+        std::println("Hans Meier: {}", number.value_or(0));
+
+        number = book.search("Otto", "Meier");
+        std::println("Otto Meier found: {}", number.has_value());
+    }
+
+    static void test_03()
+    {
+        // concurrent interning, then read-only sharing
+        auto pool{ std::make_shared<StringPool>() };
+
+        constexpr std::array<std::string_view, 6> Names{
+            "Hans", "Sepp", "Georg", "Anton", "Franz", "Hubert"
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t t{}; t != 4; ++t) {
+                threads.emplace_back([&, t] {
+                    for (std::size_t i{}; i != 10'000; ++i) {
+                        pool->intern(Names[(i + t) % Names.size()]);
+                    }
+                });
+            }
+        }
+
+        pool->freeze();
+        std::shared_ptr<const StringPool> snapshot{ pool };
+
+        std::println("Strings after concurrent interning: {}", snapshot->size());
+        std::println("Frozen: {}", snapshot->isFrozen());
+
+        try {
+            pool->intern("Maximilian");
+        }
+        catch (const std::logic_error& ex) {
+            std::println("Exception: {}", ex.what());
+        }
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumEntries = 100'000;     // debug
+#else
+    static constexpr std::size_t NumEntries = 2'000'000;   // release
+#endif
+
+    static constexpr std::array<std::string_view, 10> FirstNames{
+        "Hans", "Sepp", "Georg", "Anton", "Franz",
+        "Hubert", "Maximilian", "Franziska", "Elisabeth", "Konstantin"
+    };
+
+    static constexpr std::array<std::string_view, 10> LastNames{
+        "Meier", "Mueller", "Schneider", "Huber", "Wagner",
+        "Oberhuber-Schmidtbauer", "Wittelsbacher", "Hohenzollern", "Schwarzenberger", "Lichtenstein"
+    };
+
+    template <typename TPhoneBook>
+    static void benchmark(std::string_view label, TPhoneBook& book)
+    {
+        std::println("{}", label);
+
+        {
+            std::println("Inserting {} entries:", NumEntries);
+            ScopedTimer watch{};
+
+            for (std::size_t i{}; i != NumEntries; ++i) {
+                book.insert(FirstNames[i % FirstNames.size()], LastNames[(i / 7) % (LastNames.size() - 1)], i);
+            }
+
+            // the last name occurs only once
+            book.insert("Hans", LastNames.back(), NumEntries);
+        }
+
+        {
+            std::println("Searching (known names, no match, full scan):");
+            ScopedTimer watch{};
+
+            auto number{ book.search("Georg", LastNames.back()) };
+            std::println("Found: {}", number.has_value());
+        }
+    }
+
+    static void test_04()
+    {
+        PhoneBookStrings bookStrings{};
+        benchmark("Phonebook with std::string names:", bookStrings);
+
+        StringPool pool{};
+        PhoneBookInterned bookInterned{ pool };
+        benchmark("Phonebook with interned names:", bookInterned);
+
+        std::println("Memory std::string version: {:>12} bytes", bookStrings.bytes());
+        std::println("Memory interned version:    {:>12} bytes (+ {} bytes in pool)",
+            bookInterned.bytes(), pool.bytes());
+    }
+}
+
+void main_transform_string_interning()
+{
+    using namespace StringInterning;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -0,0 +1,246 @@
+// =====================================================================================
+// Transform_Views.cpp // Projections without intermediate containers
+// =====================================================================================
+
+module modern_cpp:transform;
+
+import std;
+import scoped_timer;
+
+namespace TransformViews {
+
+    // =================================================================================
+    // keys, values, zip: lightweight views - nothing is copied,
+    // the elements are references into the underlying containers
+    // =================================================================================
+
+    template <typename TMap>
+    static auto keys(const TMap& map)
+    {
+        return std::views::keys(map);
+    }
+
+    template <typename TMap>
+    static auto values(TMap& map)
+    {
+        return std::views::values(map);
+    }
+
+    template <typename TRange1, typename TRange2>
+    static auto zip(TRange1& range1, TRange2& range2)
+    {
+        return std::views::zip(range1, range2);
+    }
+
+    // =================================================================================
+    // transformInto: std::transform into a preallocated output range,
+    // the work is split into contiguous chunks - one chunk per thread
+    // =================================================================================
+
+    template <typename TInput, typename TOutput, typename TFunc>
+        requires std::ranges::random_access_range<const TInput>&&
+                 std::ranges::sized_range<const TInput>&&
+                 std::ranges::random_access_range<TOutput>
+    static void transformInto(const TInput& input, TOutput& output, TFunc func,
+        std::size_t numThreads = std::thread::hardware_concurrency())
+    {
+        const std::size_t size{ std::ranges::size(input) };
+
+        if (std::ranges::size(output) < size) {
+            throw std::invalid_argument{ "transformInto: output range too small" };
+        }
+
+        // small inputs are not worth starting threads
+        static constexpr std::size_t MinChunkSize{ 10'000 };
+
+        numThreads = std::clamp<std::size_t>(numThreads, 1, std::max<std::size_t>(1, size / MinChunkSize));
+
+        const auto first{ std::ranges::begin(input) };
+        const auto dest{ std::ranges::begin(output) };
+
+        auto worker = [&](std::size_t begin, std::size_t end) {
+            std::transform(first + begin, first + end, dest + begin, func);
+        };
+
+        if (numThreads == 1) {
+            worker(0, size);
+            return;
+        }
+
+        const std::size_t chunkSize{ (size + numThreads - 1) / numThreads };
+
+        std::vector<std::jthread> threads;
+        threads.reserve(numThreads - 1);
+
+        // the calling thread processes the last chunk itself
+        for (std::size_t t{}; t != numThreads - 1; ++t) {
+            threads.emplace_back(worker, std::min(size, t * chunkSize), std::min(size, (t + 1) * chunkSize));
+        }
+
+        worker(std::min(size, (numThreads - 1) * chunkSize), size);
+    }
+
+    // =================================================================================
+    // testing (compare with Transform.cpp)
+    // =================================================================================
+
+    static void test_01()
+    {
+        std::unordered_map<std::string, std::size_t> phonebook
+        {
+            { "Hans Meier" ,     12345678 },
+            { "Franz Schneider", 81726354 },
+            { "Hubert Mueller",  87654321 }
+        };
+
+        // no std::vector<std::string> needed - names are printed directly from the map
+        std::println("List of Persons: ");
+        for (const std::string& name : keys(phonebook)) {
+            std::println("{}", name);
+        }
+
+        // values are references, they can be modified in place
+        for (std::size_t& number : values(phonebook)) {
+            number += 1;
+        }
+
+        std::println("List of Numbers: ");
+        for (std::size_t number : values(phonebook)) {
+            std::println("{}", number);
+        }
+    }
+
+    static void test_02()
+    {
+        std::vector<std::string> persons
+        {
+            std::string{ "Hans Meier" },
+            std::string{ "Hubert Mueller" },
+            std::string{ "Franz Schneider" }
+        };
+
+        std::vector<std::size_t> numbers{ 12345678, 7654321, 81726354 };
+
+        // no third container - pairs of references are created on the fly
+        std::println("List of Contacts: ");
+        for (const auto& [name, number] : zip(persons, numbers)) {
+            std::println("{}: {}", name, number);
+        }
+
+        // if a map is needed nevertheless, it is built directly from the view
+        std::unordered_map<std::string_view, std::size_t> contacts{};
+        for (const auto& [name, number] : zip(persons, numbers)) {
+            contacts.emplace(name, number);
+        }
+        std::println("Contacts: {}", contacts.size());
+    }
+
+    static void test_03()
+    {
+        std::vector<std::string> names{ "Hans", "Sepp", "Georg", "Anton" };
+
+        std::vector<std::size_t> lengths(names.size());   // preallocated output
+
+        transformInto(names, lengths, [](const std::string& name) { return name.size(); });
+
+        for (const auto& [name, length] : zip(names, lengths)) {
+            std::println("{}: {}", name, length);
+        }
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumEntries = 100'000;     // debug
+    static constexpr std::size_t NumValues = 1'000'000;    // debug
+#else
+    static constexpr std::size_t NumEntries = 1'000'000;   // release
+    static constexpr std::size_t NumValues = 50'000'000;   // release
+#endif
+
+    static void test_04()
+    {
+        std::unordered_map<std::string, std::size_t> phonebook;
+        phonebook.reserve(NumEntries);
+
+        for (std::size_t i{}; i != NumEntries; ++i) {
+            phonebook.emplace(std::format("Person with a long name No. {}", i), i);
+        }
+
+        std::size_t totalLength{};
+
+        std::println("Copying names into std::vector<std::string> (std::transform):");
+        {
+            ScopedTimer watch{};
+
+            std::vector<std::string> names{};
+            names.reserve(phonebook.size());
+
+            std::transform(
+                phonebook.begin(),
+                phonebook.end(),
+                std::back_inserter(names),
+                [](const std::pair<const std::string, std::size_t>& entry) {
+                    return std::get<0>(entry);
+                }
+            );
+
+            for (const auto& name : names) {
+                totalLength += name.size();
+            }
+        }
+        std::println("Total length: {}", totalLength);
+
+        totalLength = 0;
+
+        std::println("Iterating names with keys(phonebook):");
+        {
+            ScopedTimer watch{};
+
+            for (const auto& name : keys(phonebook)) {
+                totalLength += name.size();
+            }
+        }
+        std::println("Total length: {}", totalLength);
+    }
+
+    static void test_05()
+    {
+        std::vector<double> values(NumValues);
+        std::iota(values.begin(), values.end(), 0.0);
+
+        std::vector<double> results(values.size());
+
+        auto func = [](double x) { return std::sqrt(x) * std::sin(x) + std::cos(x); };
+
+        std::println("std::transform:");
+        {
+            ScopedTimer watch{};
+            std::transform(values.begin(), values.end(), results.begin(), func);
+        }
+        std::println("Result: {}", results.back());
+
+        std::println("transformInto ({} threads):", std::thread::hardware_concurrency());
+        {
+            ScopedTimer watch{};
+            transformInto(values, results, func);
+        }
+        std::println("Result: {}", results.back());
+    }
+}
+
+void main_transform_views()
+{
+    using namespace TransformViews;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+    test_05();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
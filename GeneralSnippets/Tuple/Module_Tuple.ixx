@@ -5,6 +5,7 @@
 export module modern_cpp:tuple;
 
 export void main_tuple();
+export void main_tuple_soa_vector();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,341 @@
+// =====================================================================================
+// Tuple_SoaVector.cpp // Struct of Arrays: one std::vector per tuple element
+// =====================================================================================
+
+module modern_cpp:tuple;
+
+import std;
+
+namespace TupleSoaVector {
+
+    // =================================================================================
+    // Tuple.cpp stores its rows in a std::vector<std::tuple<...>> (Array of Structs):
+    // a scan of a single field loads all other fields of the rows into the cache, too.
+    //
+    // soa_vector<Ts...> keeps one contiguous column per tuple element. A row is
+    // accessed as a tuple of references, a column as a std::span.
+    //
+    // Note: the iterator returns proxies (tuples of references) like std::views::zip.
+    // For the classic algorithms it is an input iterator only, for the ranges
+    // algorithms a random access iterator (C++23: common reference of tuples).
+    // =================================================================================
+
+    template <typename... Ts>
+    class soa_vector
+    {
+    public:
+        using value_type      = std::tuple<Ts...>;
+        using reference       = std::tuple<Ts&...>;
+        using const_reference = std::tuple<const Ts&...>;
+        using size_type       = std::size_t;
+
+        // =============================================================================
+        // iterator
+
+        template <bool Const>
+        class Iterator
+        {
+        private:
+            template <typename T>
+            using Element = std::conditional_t<Const, const T, T>;
+
+            std::tuple<Element<Ts>*...> m_columns{};
+            std::ptrdiff_t              m_index{};
+
+        public:
+            using iterator_concept  = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = std::tuple<Ts...>;
+            using reference         = std::tuple<Element<Ts>&...>;
+            using difference_type   = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            Iterator(std::tuple<Element<Ts>*...> columns, std::ptrdiff_t index)
+                : m_columns{ columns }, m_index{ index }
+            {}
+
+            // iterator -> const_iterator
+            template <bool OtherConst>
+                requires (Const && !OtherConst)
+            Iterator(const Iterator<OtherConst>& other)
+                : m_columns{ other.m_columns }, m_index{ other.m_index }
+            {}
+
+            reference operator*() const {
+                return std::apply([this](auto*... columns) { return reference{ columns[m_index]... }; }, m_columns);
+            }
+
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            Iterator& operator++() { ++m_index; return *this; }
+            Iterator operator++(int) { Iterator tmp{ *this }; ++m_index; return tmp; }
+            Iterator& operator--() { --m_index; return *this; }
+            Iterator operator--(int) { Iterator tmp{ *this }; --m_index; return tmp; }
+
+            Iterator& operator+=(difference_type n) { m_index += n; return *this; }
+            Iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+
+            friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+            friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+            friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+
+            friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) {
+                return lhs.m_index - rhs.m_index;
+            }
+
+            friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+                return lhs.m_index == rhs.m_index;
+            }
+
+            friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) {
+                return lhs.m_index <=> rhs.m_index;
+            }
+
+            friend class Iterator<!Const>;
+        };
+
+        using iterator       = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+    private:
+        std::tuple<std::vector<Ts>...> m_columns;
+
+    public:
+        soa_vector() = default;
+
+        soa_vector(std::initializer_list<value_type> rows) {
+            reserve(rows.size());
+            for (const auto& row : rows) {
+                push_back(row);
+            }
+        }
+
+        // =============================================================================
+        // size
+
+        size_type size() const noexcept { return std::get<0>(m_columns).size(); }
+        bool empty() const noexcept { return size() == 0; }
+
+        void reserve(size_type count) {
+            std::apply([=](auto&... columns) { (columns.reserve(count), ...); }, m_columns);
+        }
+
+        void clear() noexcept {
+            std::apply([](auto&... columns) { (columns.clear(), ...); }, m_columns);
+        }
+
+        // =============================================================================
+        // rows
+
+        void push_back(const value_type& row) {
+            emplaceRow(row, std::index_sequence_for<Ts...>{});
+        }
+
+        void push_back(value_type&& row) {
+            emplaceRow(std::move(row), std::index_sequence_for<Ts...>{});
+        }
+
+        template <typename... TArgs>
+            requires (sizeof...(TArgs) == sizeof...(Ts))
+        reference emplace_back(TArgs&&... args) {
+            emplaceRow(std::forward_as_tuple(std::forward<TArgs>(args)...), std::index_sequence_for<Ts...>{});
+            return back();
+        }
+
+        void pop_back() {
+            std::apply([](auto&... columns) { (columns.pop_back(), ...); }, m_columns);
+        }
+
+        reference operator[](size_type index) {
+            return std::apply([=](auto&... columns) { return reference{ columns[index]... }; }, m_columns);
+        }
+
+        const_reference operator[](size_type index) const {
+            return std::apply([=](const auto&... columns) { return const_reference{ columns[index]... }; }, m_columns);
+        }
+
+        reference back() { return (*this)[size() - 1]; }
+        const_reference back() const { return (*this)[size() - 1]; }
+
+        // =============================================================================
+        // columns
+
+        template <std::size_t I>
+        auto column() noexcept {
+            return std::span{ std::get<I>(m_columns) };
+        }
+
+        template <std::size_t I>
+        auto column() const noexcept {
+            return std::span{ std::get<I>(m_columns) };
+        }
+
+        // =============================================================================
+        // iteration over rows
+
+        iterator begin() noexcept { return { data(), 0 }; }
+        iterator end() noexcept { return { data(), static_cast<std::ptrdiff_t>(size()) }; }
+
+        const_iterator begin() const noexcept { return { data(), 0 }; }
+        const_iterator end() const noexcept { return { data(), static_cast<std::ptrdiff_t>(size()) }; }
+
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+
+    private:
+        std::tuple<Ts*...> data() noexcept {
+            return std::apply([](auto&... columns) { return std::tuple<Ts*...>{ columns.data()... }; }, m_columns);
+        }
+
+        std::tuple<const Ts*...> data() const noexcept {
+            return std::apply([](const auto&... columns) { return std::tuple<const Ts*...>{ columns.data()... }; }, m_columns);
+        }
+
+        // strong exception guarantee: columns already extended are shrunk again
+        template <typename TRow, std::size_t... Is>
+        void emplaceRow(TRow&& row, std::index_sequence<Is...>)
+        {
+            const size_type oldSize{ size() };
+
+            try {
+                (std::get<Is>(m_columns).emplace_back(std::get<Is>(std::forward<TRow>(row))), ...);
+            }
+            catch (...) {
+                ((std::get<Is>(m_columns).size() > oldSize ? std::get<Is>(m_columns).pop_back() : void()), ...);
+                throw;
+            }
+        }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    using Row = std::tuple<int, char, double, std::string>;     // as in Tuple.cpp
+
+    static void test_01()
+    {
+        soa_vector<int, char, double, std::string> sheet{
+            { 10, 'A', 1.11, "Mueller" },
+            { 11, 'B', 2.22, "Sepp" }
+        };
+
+        sheet.push_back(Row{ 12, 'C', 3.33, "Hans" });
+        sheet.emplace_back(13, 'D', 4.44, "Franz");
+
+        // row access: tuple of references
+        std::get<2>(sheet[0]) = 1.5;
+
+        // structured binding
+        for (auto [id, abbr, val, name] : sheet) {
+            std::println("Id: {} - Abbr: {} - Value: {} - Name: {}", id, abbr, val, name);
+        }
+
+        // column access
+        std::span<double> values{ sheet.column<2>() };
+        std::println("Sum of values: {}", std::accumulate(values.begin(), values.end(), 0.0));
+
+        // standard algorithms with rows
+        auto pos{ std::find_if(sheet.begin(), sheet.end(), [](const auto& row) { return std::get<3>(row) == "Hans"; }) };
+        std::println("Hans has Id {}", std::get<0>(*pos));
+
+        const auto count{ std::count_if(sheet.begin(), sheet.end(), [](const auto& row) { return std::get<2>(row) > 2.0; }) };
+        std::println("Rows with value > 2.0: {}", count);
+
+        std::for_each(sheet.begin(), sheet.end(), [](auto row) { std::get<2>(row) *= 2.0; });
+        std::println("Row 3 after doubling: {}", std::get<2>(sheet[3]));
+    }
+
+    // =================================================================================
+    // benchmark: scanning a single field, AoS vs. SoA
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumRows = 100'000;        // debug
+    static constexpr std::size_t Repetitions = 10;
+#else
+    static constexpr std::size_t NumRows = 5'000'000;      // release
+    static constexpr std::size_t Repetitions = 20;
+#endif
+
+    template <typename TScan>
+    static void measure(std::string_view label, TScan scan)
+    {
+        double result{};
+
+        const auto start{ std::chrono::steady_clock::now() };
+        for (std::size_t i{}; i != Repetitions; ++i) {
+            result += scan();
+        }
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double, std::milli> elapsed{ end - start };
+        std::println("  {:<40}{:8.2f} ms  (result {})", label, elapsed.count() / Repetitions, result);
+    }
+
+    static void test_02()
+    {
+        std::vector<Row> aos{};
+        aos.reserve(NumRows);
+
+        soa_vector<int, char, double, std::string> soa{};
+        soa.reserve(NumRows);
+
+        std::mt19937 engine{ 42 };
+        std::uniform_real_distribution<double> values{ 0.0, 100.0 };
+
+        for (std::size_t i{}; i != NumRows; ++i) {
+            Row row{ static_cast<int>(i), static_cast<char>('A' + i % 26), values(engine), "Name" };
+            aos.push_back(row);
+            soa.push_back(std::move(row));
+        }
+
+        std::println("{} rows, sizeof(Row) = {}:", NumRows, sizeof(Row));
+
+        std::println("Sum of the double field:");
+
+        measure("std::vector<std::tuple<...>>:", [&] {
+            double sum{};
+            for (const auto& row : aos) {
+                sum += std::get<2>(row);
+            }
+            return sum;
+        });
+
+        measure("soa_vector - column<2>():", [&] {
+            const auto column{ soa.column<2>() };
+            return std::accumulate(column.begin(), column.end(), 0.0);
+        });
+
+        measure("soa_vector - iterating rows:", [&] {
+            double sum{};
+            for (const auto& row : soa) {
+                sum += std::get<2>(row);
+            }
+            return sum;
+        });
+
+        std::println("Count of the char field equal to 'X':");
+
+        measure("std::vector<std::tuple<...>>:", [&] {
+            return static_cast<double>(std::count_if(aos.begin(), aos.end(), [](const auto& row) { return std::get<1>(row) == 'X'; }));
+        });
+
+        measure("soa_vector - column<1>():", [&] {
+            const auto column{ soa.column<1>() };
+            return static_cast<double>(std::count(column.begin(), column.end(), 'X'));
+        });
+    }
+}
+
+void main_tuple_soa_vector()
+{
+    using namespace TupleSoaVector;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,8 @@
 export module modern_cpp:unique_ptr;
 
 export void main_unique_ptr();
+export void main_unique_ptr_digit_conversion();
+export void main_unique_ptr_pool_deleter();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,367 @@
+// =====================================================================================
+// UniquePtr_DigitConversion.cpp // Splitting numbers into digits without heap allocations
+// =====================================================================================
+
+module modern_cpp:unique_ptr;
+
+import std;
+import scoped_timer;
+
+namespace DigitConversion {
+
+    // =================================================================================
+    // Exercise 5 of Exercises_15_SmartPointers.cpp returns the digits of a number
+    // in a std::unique_ptr<std::size_t[]>: one heap allocation and 8 bytes per digit.
+    // An unsigned 64-bit number has at most 20 digits - a fixed buffer on the stack
+    // is always large enough.
+    // =================================================================================
+
+    static constexpr std::size_t MaxDigits{ 20 };   // std::numeric_limits<std::uint64_t>::max()
+
+    // =================================================================================
+    // digit counting: log10 from the bit width, corrected with one table lookup
+    // (1233 / 4096 is an approximation of log10(2))
+    // =================================================================================
+
+    static constexpr auto PowersOf10 = [] {
+        std::array<std::uint64_t, MaxDigits> powers{};
+        std::uint64_t power{ 1 };
+        for (auto& entry : powers) {
+            entry = power;
+            power *= 10;
+        }
+        return powers;
+    }();
+
+    constexpr std::size_t digitCount(std::uint64_t value) noexcept
+    {
+        value |= 1;   // 0 has one digit
+
+        const std::size_t log10{ (static_cast<std::size_t>(std::bit_width(value)) * 1233) >> 12 };
+        return log10 + 1 - (value < PowersOf10[log10]);
+    }
+
+    static_assert(digitCount(0) == 1);
+    static_assert(digitCount(9) == 1);
+    static_assert(digitCount(10) == 2);
+    static_assert(digitCount(99'999) == 5);
+    static_assert(digitCount(100'000) == 6);
+    static_assert(digitCount(std::numeric_limits<std::uint64_t>::max()) == 20);
+
+    // =================================================================================
+    // conversion: two digits per division, taken from a table "00" ... "99"
+    // =================================================================================
+
+    static constexpr auto DigitPairs = [] {
+        std::array<char, 200> pairs{};
+        for (std::size_t i{}; i != 100; ++i) {
+            pairs[2 * i] = static_cast<char>('0' + i / 10);
+            pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+        return pairs;
+    }();
+
+    // writes the digits of value backwards, the last one at last - 1
+    static void writeDigits(char* last, std::uint64_t value) noexcept
+    {
+        while (value >= 100) {
+            const std::size_t index{ static_cast<std::size_t>(value % 100) * 2 };
+            value /= 100;
+            last -= 2;
+            last[0] = DigitPairs[index];
+            last[1] = DigitPairs[index + 1];
+        }
+
+        if (value >= 10) {
+            const std::size_t index{ static_cast<std::size_t>(value) * 2 };
+            last[-2] = DigitPairs[index];
+            last[-1] = DigitPairs[index + 1];
+        }
+        else {
+            last[-1] = static_cast<char>('0' + value);
+        }
+    }
+
+    // precondition: at least digitCount(value) characters are available at first,
+    // returns the end of the written characters (no terminating '\0')
+    static char* toChars(char* first, std::uint64_t value) noexcept
+    {
+        char* last{ first + digitCount(value) };
+        writeDigits(last, value);
+        return last;
+    }
+
+    // checked variant with the interface of std::to_chars
+    static std::to_chars_result toChars(std::span<char> buffer, std::uint64_t value) noexcept
+    {
+        const std::size_t count{ digitCount(value) };
+        if (buffer.size() < count) {
+            return { buffer.data() + buffer.size(), std::errc::value_too_large };
+        }
+
+        writeDigits(buffer.data() + count, value);
+        return { buffer.data() + count, std::errc{} };
+    }
+
+    // =================================================================================
+    // Digits: the result of splitting a number, returned by value - no allocation
+    // =================================================================================
+
+    class Digits
+    {
+    private:
+        std::array<char, MaxDigits> m_chars;
+        std::uint8_t                m_count;
+
+    public:
+        explicit Digits(std::uint64_t value) noexcept : m_chars{}, m_count{}
+        {
+            m_count = static_cast<std::uint8_t>(toChars(m_chars.data(), value) - m_chars.data());
+        }
+
+        std::size_t count() const noexcept { return m_count; }
+
+        // i-th digit from the left as number 0 ... 9
+        std::size_t operator[] (std::size_t index) const noexcept {
+            return static_cast<std::size_t>(m_chars[index] - '0');
+        }
+
+        std::string_view view() const noexcept { return { m_chars.data(), m_count }; }
+    };
+
+    // =================================================================================
+    // batch conversion: many numbers into one contiguous text buffer
+    // =================================================================================
+
+    // every number needs at most MaxDigits characters plus separator
+    constexpr std::size_t maxTextSize(std::size_t count) noexcept
+    {
+        return count * (MaxDigits + 1);
+    }
+
+    // returns the number of characters written
+    static std::size_t toText(std::span<const std::uint64_t> values, std::span<char> buffer, char separator = '\n')
+    {
+        if (buffer.size() < maxTextSize(values.size())) {
+            throw std::invalid_argument{ "toText: buffer too small" };
+        }
+
+        // no further bounds checks inside of the loop
+        char* pos{ buffer.data() };
+        for (std::uint64_t value : values) {
+            pos = toChars(pos, value);
+            *pos++ = separator;
+        }
+
+        return static_cast<std::size_t>(pos - buffer.data());
+    }
+
+    static std::string toText(std::span<const std::uint64_t> values, char separator = '\n')
+    {
+        std::string text{};
+
+        text.resize_and_overwrite(
+            maxTextSize(values.size()),
+            [&](char* buffer, std::size_t size) { return toText(values, { buffer, size }, separator); }
+        );
+
+        return text;
+    }
+
+    // =================================================================================
+    // reference implementation (Variant 1 of Exercise 5)
+    // =================================================================================
+
+    static std::size_t countDigits(std::size_t n)
+    {
+        std::size_t count{};
+
+        do {
+            n /= 10;
+            ++count;
+        } while (n != 0);
+
+        return count;
+    }
+
+    static std::unique_ptr<std::size_t[]> splitToDigits(std::size_t number, std::size_t& count)
+    {
+        count = countDigits(number);
+
+        std::unique_ptr<std::size_t[]> digits{ std::make_unique<std::size_t[]>(count) };
+
+        std::size_t index{};
+        do {
+            digits[count - index - 1] = number % 10;
+            number /= 10;
+            ++index;
+        } while (number != 0);
+
+        return digits;
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        Digits digits{ 12345 };
+
+        std::println("Splitting of {}:", digits.view());
+        for (std::size_t i{}; i != digits.count(); ++i) {
+            std::println("{}: {}", i, digits[i]);
+        }
+
+        std::array<char, MaxDigits> buffer{};
+        char* end{ toChars(buffer.data(), std::numeric_limits<std::uint64_t>::max()) };
+        std::println("Max: {}", std::string_view{ buffer.data(), end });
+
+        char small[4]{};
+        auto [ptr, ec] { toChars(std::span<char>{ small }, 12345) };
+        std::println("Too small: {}", ec == std::errc::value_too_large);
+
+        std::vector<std::uint64_t> values{ 0, 7, 42, 100, 65535, 1'000'000'007 };
+        std::print("{}", toText(values));
+    }
+
+    static void test_02()
+    {
+        // compare with std::to_chars for all digit counts
+        std::mt19937_64 engine{ 1 };
+        std::size_t mismatches{};
+
+        for (std::size_t i{}; i != 1'000'000; ++i) {
+            const std::uint64_t value{ engine() >> (engine() % 64) };
+
+            char expected[MaxDigits]{};
+            char actual[MaxDigits]{};
+
+            auto [last1, ec1] { std::to_chars(std::begin(expected), std::end(expected), value) };
+            char* last2{ toChars(actual, value) };
+
+            if (std::string_view{ expected, last1 } != std::string_view{ actual, last2 } ||
+                digitCount(value) != countDigits(value)) {
+                ++mismatches;
+            }
+        }
+
+        std::println("Mismatches: {}", mismatches);
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumValues = 1'000'000;       // debug
+#else
+    static constexpr std::size_t NumValues = 20'000'000;      // release
+#endif
+
+    // all digit counts (1 ... 19) are equally frequent
+    static std::vector<std::uint64_t> makeValues()
+    {
+        std::mt19937_64 engine{ 42 };
+        std::uniform_int_distribution<std::size_t> digits{ 1, MaxDigits - 1 };
+
+        std::vector<std::uint64_t> values(NumValues);
+        for (auto& value : values) {
+            const std::size_t count{ digits(engine) };
+            value = PowersOf10[count - 1] + engine() % (PowersOf10[count] - PowersOf10[count - 1]);
+        }
+
+        return values;
+    }
+
+    static void test_03()
+    {
+        const auto values{ makeValues() };
+
+        std::size_t total{};
+
+        std::println("countDigits (divide loop):");
+        {
+            ScopedTimer watch{};
+            for (auto value : values) {
+                total += countDigits(value);
+            }
+        }
+        std::println("Digits: {}", total);
+
+        total = 0;
+        std::println("digitCount (bit_width + table):");
+        {
+            ScopedTimer watch{};
+            for (auto value : values) {
+                total += digitCount(value);
+            }
+        }
+        std::println("Digits: {}", total);
+
+        total = 0;
+        std::println("splitToDigits (std::unique_ptr<std::size_t[]>):");
+        {
+            ScopedTimer watch{};
+            for (auto value : values) {
+                std::size_t count{};
+                auto digits{ splitToDigits(value, count) };
+                total += digits[0];
+            }
+        }
+        std::println("Sum of leading digits: {}", total);
+
+        total = 0;
+        std::println("Digits (std::array<char, 20>):");
+        {
+            ScopedTimer watch{};
+            for (auto value : values) {
+                Digits digits{ value };
+                total += digits[0];
+            }
+        }
+        std::println("Sum of leading digits: {}", total);
+    }
+
+    static void test_04()
+    {
+        const auto values{ makeValues() };
+
+        std::vector<char> buffer(maxTextSize(values.size()));
+        std::size_t size{};
+
+        std::println("std::to_chars (one value after another):");
+        {
+            ScopedTimer watch{};
+
+            char* pos{ buffer.data() };
+            char* end{ buffer.data() + buffer.size() };
+            for (auto value : values) {
+                pos = std::to_chars(pos, end, value).ptr;
+                *pos++ = '\n';
+            }
+            size = static_cast<std::size_t>(pos - buffer.data());
+        }
+        std::println("Characters: {}", size);
+
+        std::println("toText (batch):");
+        {
+            ScopedTimer watch{};
+            size = toText(values, buffer);
+        }
+        std::println("Characters: {}", size);
+    }
+}
+
+void main_unique_ptr_digit_conversion()
+{
+    using namespace DigitConversion;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
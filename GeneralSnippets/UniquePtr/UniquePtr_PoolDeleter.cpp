@@ -0,0 +1,479 @@
+// =====================================================================================
+// UniquePtr_PoolDeleter.cpp // std::unique_ptr with a deleter returning resources to a pool
+// =====================================================================================
+
+module;
+
+#include <stdio.h>
+
+module modern_cpp:unique_ptr;
+
+import std;
+import scoped_timer;
+
+namespace UniquePointerPoolDeleter {
+
+    // =================================================================================
+    // PoolTraits<T>: how a resource is destroyed for real and how it is reset,
+    // before it is handed out once again
+    // =================================================================================
+
+    template <typename T>
+    struct PoolTraits
+    {
+        static void destroy(T* resource) noexcept {
+            delete resource;
+        }
+
+        // returns false, if the resource can't be reused
+        static bool reset(T* resource) noexcept {
+            if constexpr (requires { resource->clear(); }) {
+                resource->clear();   // containers keep their capacity
+            }
+            return true;
+        }
+    };
+
+    template <>
+    struct PoolTraits<FILE>
+    {
+        static void destroy(FILE* file) noexcept {
+            fclose(file);
+        }
+
+        // rewind instead of reopening
+        static bool reset(FILE* file) noexcept {
+            clearerr(file);
+            return fseek(file, 0, SEEK_SET) == 0;
+        }
+    };
+
+    // =================================================================================
+    // PoolDeleter<T>: custom deleter for std::unique_ptr<T, PoolDeleter<T>>
+    //
+    // Instead of closing the resource, it is returned to its pool.
+    // A default constructed PoolDeleter (no pool) destroys the resource directly.
+    // Note: the pool must outlive all std::unique_ptr objects handed out by it.
+    // =================================================================================
+
+    template <typename T, typename TTraits>
+    class ResourcePool;
+
+    template <typename T, typename TTraits = PoolTraits<T>>
+    class PoolDeleter
+    {
+    private:
+        ResourcePool<T, TTraits>* m_pool;
+
+    public:
+        PoolDeleter() noexcept : m_pool{ nullptr } {}
+
+        explicit PoolDeleter(ResourcePool<T, TTraits>* pool) noexcept : m_pool{ pool } {}
+
+        void operator() (T* resource) const noexcept
+        {
+            if (m_pool != nullptr) {
+                m_pool->release(resource);
+            }
+            else {
+                TTraits::destroy(resource);
+            }
+        }
+    };
+
+    struct PoolStatistics
+    {
+        std::size_t m_created;      // resources created by the factory
+        std::size_t m_reused;       // acquisitions served from the pool
+        std::size_t m_discarded;    // returned resources destroyed: pool full or reset failed
+        std::size_t m_evicted;      // destroyed after being idle too long
+    };
+
+    // =================================================================================
+    // ResourcePool<T>
+    //
+    // - bounded: at most 'capacity' idle resources are kept
+    // - LIFO: the most recently returned resource is reused first (warm caches),
+    //   therefore the idle resources at the front are the oldest ones
+    // - idle resources older than 'maxIdle' are evicted when resources are
+    //   returned or on explicit calls of evictIdle()
+    // - thread-safe
+    // =================================================================================
+
+    template <typename T, typename TTraits = PoolTraits<T>>
+    class ResourcePool
+    {
+    public:
+        using Handle = std::unique_ptr<T, PoolDeleter<T, TTraits>>;
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        struct Idle
+        {
+            T*                m_resource;
+            Clock::time_point m_since;
+        };
+
+        std::function<T*()>       m_factory;
+        std::size_t               m_capacity;
+        Clock::duration           m_maxIdle;
+
+        mutable std::mutex        m_mutex;
+        std::vector<Idle>         m_idle;
+        PoolStatistics            m_statistics;
+
+        friend class PoolDeleter<T, TTraits>;
+
+    public:
+        ResourcePool(std::function<T*()> factory, std::size_t capacity, Clock::duration maxIdle)
+            : m_factory{ std::move(factory) }, m_capacity{ capacity }, m_maxIdle{ maxIdle }, m_statistics{}
+        {
+            m_idle.reserve(capacity);
+        }
+
+        ~ResourcePool() {
+            for (const auto& idle : m_idle) {
+                TTraits::destroy(idle.m_resource);
+            }
+        }
+
+        // no copying or moving: handed out deleters point to the pool
+        ResourcePool(const ResourcePool&) = delete;
+        ResourcePool& operator=(const ResourcePool&) = delete;
+
+        ResourcePool(ResourcePool&&) noexcept = delete;
+        ResourcePool& operator=(ResourcePool&&) noexcept = delete;
+
+        // empty handle, if the factory fails
+        Handle acquire()
+        {
+            {
+                std::lock_guard guard{ m_mutex };
+
+                if (!m_idle.empty()) {
+                    T* resource{ m_idle.back().m_resource };
+                    m_idle.pop_back();
+                    ++m_statistics.m_reused;
+                    return Handle{ resource, PoolDeleter<T, TTraits>{ this } };
+                }
+            }
+
+            // the factory may be slow (open a file, ...): called without lock
+            T* resource{ m_factory() };
+            if (resource == nullptr) {
+                return Handle{ nullptr, PoolDeleter<T, TTraits>{ this } };
+            }
+
+            {
+                std::lock_guard guard{ m_mutex };
+                ++m_statistics.m_created;
+            }
+
+            return Handle{ resource, PoolDeleter<T, TTraits>{ this } };
+        }
+
+        // destroys all resources idle longer than maxIdle
+        void evictIdle()
+        {
+            std::vector<Idle> expired{};
+            {
+                std::lock_guard guard{ m_mutex };
+                expired = takeExpired(Clock::now());
+            }
+
+            for (const auto& idle : expired) {
+                TTraits::destroy(idle.m_resource);
+            }
+        }
+
+        std::size_t idle() const {
+            std::lock_guard guard{ m_mutex };
+            return m_idle.size();
+        }
+
+        PoolStatistics statistics() const {
+            std::lock_guard guard{ m_mutex };
+            return m_statistics;
+        }
+
+    private:
+        // called by PoolDeleter
+        void release(T* resource) noexcept
+        {
+            // reset outside of the lock
+            const bool reusable{ TTraits::reset(resource) };
+
+            std::vector<Idle> expired{};
+            bool discard{ false };
+
+            {
+                std::lock_guard guard{ m_mutex };
+
+                const auto now{ Clock::now() };
+
+                if (!m_idle.empty() && now - m_idle.front().m_since > m_maxIdle) {
+                    expired = takeExpired(now);
+                }
+
+                if (reusable && m_idle.size() < m_capacity) {
+                    m_idle.push_back(Idle{ resource, now });
+                }
+                else {
+                    discard = true;
+                    ++m_statistics.m_discarded;
+                }
+            }
+
+            if (discard) {
+                TTraits::destroy(resource);
+            }
+
+            for (const auto& idle : expired) {
+                TTraits::destroy(idle.m_resource);
+            }
+        }
+
+        // m_mutex is held
+        std::vector<Idle> takeExpired(Clock::time_point now)
+        {
+            auto pos{ std::find_if(m_idle.begin(), m_idle.end(), [&](const Idle& idle) {
+                return now - idle.m_since <= m_maxIdle;
+            }) };
+
+            std::vector<Idle> expired{ m_idle.begin(), pos };
+            m_idle.erase(m_idle.begin(), pos);
+            m_statistics.m_evicted += expired.size();
+            return expired;
+        }
+    };
+
+    // =================================================================================
+    // FILE pool (compare with FILE_Deleter in UniquePtr.cpp)
+    // =================================================================================
+
+    using FilePool = ResourcePool<FILE>;
+    using FILE_PooledPtr = std::unique_ptr<FILE, PoolDeleter<FILE>>;
+
+    static_assert(std::is_same_v<FilePool::Handle, FILE_PooledPtr>);
+
+    static std::function<FILE*()> fileFactory(std::string fileName, std::string mode)
+    {
+        return [fileName = std::move(fileName), mode = std::move(mode)]() -> FILE* {
+            FILE* file{ nullptr };
+            auto err{ fopen_s(&file, fileName.c_str(), mode.c_str()) };
+            return err == 0 ? file : nullptr;
+        };
+    }
+
+    // existing code using std::unique_ptr<FILE, PoolDeleter<FILE>> - no changes needed
+    static std::string readFirstLine(FILE_PooledPtr file)
+    {
+        char buffer[256]{};
+        if (fgets(buffer, sizeof(buffer), file.get()) == nullptr) {
+            return {};
+        }
+
+        std::string line{ buffer };
+        if (!line.empty() && line.back() == '\n') {
+            line.pop_back();
+        }
+        return line;
+    }
+
+    static void printStatistics(std::string_view label, const PoolStatistics& statistics)
+    {
+        std::println("{}: created: {}, reused: {}, discarded: {}, evicted: {}",
+            label, statistics.m_created, statistics.m_reused, statistics.m_discarded, statistics.m_evicted);
+    }
+
+    static std::filesystem::path createTestFile()
+    {
+        auto path{ std::filesystem::temp_directory_path() / "UniquePtr_PoolDeleter.txt" };
+
+        std::ofstream file{ path };
+        for (int i{ 1 }; i <= 100; ++i) {
+            file << "Line " << i << '\n';
+        }
+
+        return path;
+    }
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        const auto path{ createTestFile() };
+
+        FilePool pool{ fileFactory(path.string(), "r"), 4, std::chrono::milliseconds{ 50 } };
+
+        for (int i{}; i != 3; ++i) {
+            FILE_PooledPtr file{ pool.acquire() };
+            if (!file) {
+                std::println("Cannot open file {}!", path.string());
+                return;
+            }
+
+            // every reuse starts at the beginning of the file
+            std::println("First Line: {}", readFirstLine(std::move(file)));
+        }
+
+        printStatistics("FilePool", pool.statistics());
+
+        {
+            // 6 files at the same time - only 4 of them are kept
+            std::vector<FILE_PooledPtr> files{};
+            for (int i{}; i != 6; ++i) {
+                files.push_back(pool.acquire());
+            }
+        }
+        printStatistics("FilePool", pool.statistics());
+        std::println("Idle: {}", pool.idle());
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+        pool.evictIdle();
+        printStatistics("FilePool", pool.statistics());
+        std::println("Idle: {}", pool.idle());
+
+        std::filesystem::remove(path);
+    }
+
+    static void test_02()
+    {
+        // buffers: cleared on return, the capacity is kept
+        using Buffer = std::vector<char>;
+
+        ResourcePool<Buffer> pool{
+            [] { auto buffer{ new Buffer{} }; buffer->reserve(64 * 1024); return buffer; },
+            8,
+            std::chrono::seconds{ 10 }
+        };
+
+        for (int i{}; i != 5; ++i) {
+            std::unique_ptr<Buffer, PoolDeleter<Buffer>> buffer{ pool.acquire() };
+            std::println("Size: {}, Capacity: {}", buffer->size(), buffer->capacity());
+            buffer->resize(1000);
+        }
+
+        printStatistics("BufferPool", pool.statistics());
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumIterations = 10'000;      // debug
+#else
+    static constexpr std::size_t NumIterations = 100'000;     // release
+#endif
+
+    struct FILE_Deleter
+    {
+        void operator() (FILE* file) const {
+            if (file != nullptr) {
+                fclose(file);
+            }
+        }
+    };
+
+    static void test_03()
+    {
+        const auto path{ createTestFile() };
+        const std::string fileName{ path.string() };
+
+        std::size_t total{};
+
+        std::println("std::unique_ptr<FILE, FILE_Deleter> (open / close):");
+        {
+            ScopedTimer watch{};
+
+            for (std::size_t i{}; i != NumIterations; ++i) {
+                FILE* file{ nullptr };
+                if (fopen_s(&file, fileName.c_str(), "r") != 0) {
+                    break;
+                }
+
+                std::unique_ptr<FILE, FILE_Deleter> ptr{ file };
+                total += static_cast<std::size_t>(fgetc(ptr.get()));
+            }
+        }
+        std::println("Checksum: {}", total);
+
+        total = 0;
+
+        FilePool pool{ fileFactory(fileName, "r"), 16, std::chrono::seconds{ 10 } };
+
+        std::println("std::unique_ptr<FILE, PoolDeleter<FILE>> (acquire / rewind):");
+        {
+            ScopedTimer watch{};
+
+            for (std::size_t i{}; i != NumIterations; ++i) {
+                FILE_PooledPtr ptr{ pool.acquire() };
+                if (!ptr) {
+                    break;
+                }
+
+                total += static_cast<std::size_t>(fgetc(ptr.get()));
+            }
+        }
+        std::println("Checksum: {}", total);
+        printStatistics("FilePool", pool.statistics());
+
+        std::filesystem::remove(path);
+    }
+
+    static void test_04()
+    {
+        using Buffer = std::vector<char>;
+
+        static constexpr std::size_t BufferSize{ 1024 * 1024 };   // many heaps pass blocks of this size directly to the OS
+
+        // a typical request uses only a part of its buffer
+        const std::string message(4 * 1024, '*');
+
+        std::size_t total{};
+
+        std::println("std::make_unique<Buffer> per request:");
+        {
+            ScopedTimer watch{};
+
+            for (std::size_t i{}; i != NumIterations; ++i) {
+                auto buffer{ std::make_unique<Buffer>() };
+                buffer->reserve(BufferSize);
+                buffer->insert(buffer->end(), message.begin(), message.end());
+                total += buffer->size();
+            }
+        }
+
+        ResourcePool<Buffer> pool{ [] { return new Buffer{}; }, 16, std::chrono::seconds{ 10 } };
+
+        std::println("ResourcePool<Buffer>:");
+        {
+            ScopedTimer watch{};
+
+            for (std::size_t i{}; i != NumIterations; ++i) {
+                auto buffer{ pool.acquire() };
+                buffer->reserve(BufferSize);   // no-op after the first use
+                buffer->insert(buffer->end(), message.begin(), message.end());
+                total += buffer->size();
+            }
+        }
+        std::println("Checksum: {}", total);
+        printStatistics("BufferPool", pool.statistics());
+    }
+}
+
+void main_unique_ptr_pool_deleter()
+{
+    using namespace UniquePointerPoolDeleter;
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -8,6 +8,7 @@ export void main_variadic_templates_introduction();
 export void main_variadic_templates_working_on_every_argument();
 export void main_variadic_templates_sum_of_sums();
 export void main_variadic_templates_mixins();
+export void main_variadic_templates_concurrent_mixins();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,482 @@
+// =====================================================================================
+// VariadicTemplate_05_ConcurrentMixins.cpp // Variadic Templates - Mixins shared between threads
+// =====================================================================================
+
+module modern_cpp:variadic_templates;
+
+import std;
+
+namespace VariadicTemplatesConcurrentMixins {
+
+    // ===================================================================
+    // Repository<TSlots...> in VariadicTemplate_04_Mixins.cpp has no
+    // synchronization, get returns a reference into the slot.
+    // Here the slots can be shared between writer threads and many
+    // reader threads:
+    //
+    // SeqLockSlot<T>:      trivially copyable types - readers write
+    //                      nothing at all, they retry, if a write
+    //                      happened meanwhile
+    // DoubleBufferSlot<T>: all other types - the writer constructs
+    //                      the new value in the unused buffer, then
+    //                      switches; readers only increment a counter
+    // LockedSlot<T>:       std::mutex, for comparison
+    //
+    // get returns a copy (snapshot) - never a reference into the slot.
+    // Every slot starts on its own cache line (no false sharing).
+
+    static constexpr std::size_t CacheLineSize{ 64 };
+
+    struct DefaultSlotKey; // forward definition sufficient
+
+    // ===================================================================
+    // SeqLockSlot
+
+    template <typename T, typename Key = DefaultSlotKey>
+    class alignas(CacheLineSize) SeqLockSlot
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+            "SeqLockSlot: T must be trivially copyable");
+
+    public:
+        using ValueType = T;
+        using KeyType = Key;
+
+    private:
+        static constexpr std::size_t NumWords{ (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t) };
+
+        using Words = std::array<std::uint64_t, NumWords>;
+
+        // odd: write in progress
+        std::atomic<std::uint64_t> m_sequence;
+
+        // the value as atomic words: concurrent reading and writing is no data race,
+        // a torn value is detected by the sequence number and never returned
+        std::array<std::atomic<std::uint64_t>, NumWords> m_words;
+
+    protected:
+        SeqLockSlot() : m_sequence{}, m_words{} { set(T{}); }
+
+        T get() const
+        {
+            Words words{};
+
+            while (true) {
+                const std::uint64_t before{ m_sequence.load(std::memory_order_acquire) };
+
+                if (before % 2 == 1) {
+                    std::this_thread::yield();   // writer is active
+                    continue;
+                }
+
+                for (std::size_t i{}; i != NumWords; ++i) {
+                    words[i] = m_words[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (m_sequence.load(std::memory_order_relaxed) == before) {
+                    break;
+                }
+            }
+
+            std::array<unsigned char, sizeof(T)> bytes{};
+            std::memcpy(bytes.data(), words.data(), sizeof(T));
+            return std::bit_cast<T>(bytes);
+        }
+
+        template <typename TFunc>
+        decltype(auto) read(TFunc&& func) const
+        {
+            const T value{ get() };
+            return std::forward<TFunc>(func)(value);
+        }
+
+        void set(const T& value)
+        {
+            Words words{};
+            std::memcpy(words.data(), &value, sizeof(T));
+
+            // writers exclude each other: even -> odd
+            std::uint64_t sequence{ m_sequence.load(std::memory_order_relaxed) };
+            while (sequence % 2 == 1 ||
+                   !m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire))
+            {
+                sequence = m_sequence.load(std::memory_order_relaxed);
+            }
+
+            // the odd sequence number must be visible before any word
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (std::size_t i{}; i != NumWords; ++i) {
+                m_words[i].store(words[i], std::memory_order_relaxed);
+            }
+
+            m_sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        // the new value is constructed by the writer, then published as a whole
+        template <typename... TArgs>
+        void emplace(TArgs&&... args)
+        {
+            set(T(std::forward<TArgs>(args)...));
+        }
+    };
+
+    // ===================================================================
+    // DoubleBufferSlot
+
+    template <typename T, typename Key = DefaultSlotKey>
+    class alignas(CacheLineSize) DoubleBufferSlot
+    {
+    public:
+        using ValueType = T;
+        using KeyType = Key;
+
+    private:
+        std::atomic<std::uint32_t>                        m_active;     // index of the published buffer
+        mutable std::array<std::atomic<std::uint32_t>, 2> m_readers;    // readers per buffer
+        std::mutex                                        m_writer;     // writers only
+        std::array<std::optional<T>, 2>                   m_buffers;
+
+        // RAII: a reader stays registered at a buffer while using it
+        class ReadGuard
+        {
+        private:
+            const DoubleBufferSlot& m_slot;
+            std::uint32_t           m_index;
+
+        public:
+            explicit ReadGuard(const DoubleBufferSlot& slot) : m_slot{ slot }, m_index{}
+            {
+                while (true) {
+                    m_index = m_slot.m_active.load();
+                    m_slot.m_readers[m_index].fetch_add(1);
+
+                    // the writer may have switched in between:
+                    // then the buffer might be overwritten - try again
+                    if (m_slot.m_active.load() == m_index) {
+                        break;
+                    }
+
+                    m_slot.m_readers[m_index].fetch_sub(1, std::memory_order_release);
+                }
+            }
+
+            ~ReadGuard() {
+                m_slot.m_readers[m_index].fetch_sub(1, std::memory_order_release);
+            }
+
+            // no copying or moving
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+
+            ReadGuard(ReadGuard&&) noexcept = delete;
+            ReadGuard& operator=(ReadGuard&&) noexcept = delete;
+
+            const T& value() const { return *m_slot.m_buffers[m_index]; }
+        };
+
+    protected:
+        DoubleBufferSlot() : m_active{}, m_readers{}, m_writer{}, m_buffers{}
+        {
+            m_buffers[0].emplace();
+        }
+
+        T get() const
+        {
+            return read([](const T& value) { return value; });
+        }
+
+        // func sees a consistent value without copying it
+        template <typename TFunc>
+        decltype(auto) read(TFunc&& func) const
+        {
+            ReadGuard guard{ *this };
+            return std::forward<TFunc>(func)(guard.value());
+        }
+
+        void set(const T& value)
+        {
+            emplace(value);
+        }
+
+        // constructs the new value in place, in the buffer not visible to readers
+        template <typename... TArgs>
+        void emplace(TArgs&&... args)
+        {
+            std::lock_guard<std::mutex> guard{ m_writer };
+
+            const std::uint32_t inactive{ 1 - m_active.load(std::memory_order_relaxed) };
+
+            // readers still using the buffer since the previous switch
+            while (m_readers[inactive].load() != 0) {
+                std::this_thread::yield();
+            }
+
+            // an exception leaves the published buffer untouched
+            m_buffers[inactive].emplace(std::forward<TArgs>(args)...);
+
+            m_active.store(inactive);
+        }
+    };
+
+    // ===================================================================
+    // LockedSlot: for comparison
+
+    template <typename T, typename Key = DefaultSlotKey>
+    class alignas(CacheLineSize) LockedSlot
+    {
+    public:
+        using ValueType = T;
+        using KeyType = Key;
+
+    private:
+        mutable std::mutex m_mutex;
+        T                  m_value{};
+
+    protected:
+        T get() const
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+            return m_value;
+        }
+
+        template <typename TFunc>
+        decltype(auto) read(TFunc&& func) const
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+            return std::forward<TFunc>(func)(std::as_const(m_value));
+        }
+
+        void set(const T& value)
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+            m_value = value;
+        }
+
+        template <typename... TArgs>
+        void emplace(TArgs&&... args)
+        {
+            T value(std::forward<TArgs>(args)...);   // construction outside of the lock
+            std::lock_guard<std::mutex> guard{ m_mutex };
+            m_value = std::move(value);
+        }
+    };
+
+    // selects the slot type suitable for T
+    template <typename T, typename Key = DefaultSlotKey>
+    using ConcurrentSlot = std::conditional_t<
+        std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+        SeqLockSlot<T, Key>,
+        DoubleBufferSlot<T, Key>
+    >;
+
+    // ===================================================================
+    // ConcurrentRepository
+
+    template <typename... TSlots>
+    class ConcurrentRepository : private TSlots...  // inherit private from our slots...
+    {
+    private:
+        // select base class by value type and key
+        template <typename T, typename Key>
+        static constexpr std::size_t slotIndex()
+        {
+            constexpr std::array<bool, sizeof...(TSlots)> matches{
+                (std::is_same_v<T, typename TSlots::ValueType> && std::is_same_v<Key, typename TSlots::KeyType>) ...
+            };
+
+            for (std::size_t i{}; i != matches.size(); ++i) {
+                if (matches[i]) {
+                    return i;
+                }
+            }
+            return matches.size();
+        }
+
+        template <typename T, typename Key>
+        using SlotOf = std::tuple_element_t<slotIndex<T, Key>(), std::tuple<TSlots...>>;
+
+    public:
+        template <typename T, typename Key = DefaultSlotKey>
+        T get() const
+        {
+            return SlotOf<T, Key>::get();
+        }
+
+        template <typename T, typename Key = DefaultSlotKey, typename TFunc>
+        decltype(auto) read(TFunc&& func) const
+        {
+            return SlotOf<T, Key>::read(std::forward<TFunc>(func));
+        }
+
+        template <typename T, typename Key = DefaultSlotKey>
+        void set(const T& value)
+        {
+            SlotOf<T, Key>::set(value);
+        }
+
+        // using "Perfect Forwarding"
+        template <typename T, typename Key = DefaultSlotKey, typename... TArgs>
+        void emplace(TArgs&&... args)
+        {
+            SlotOf<T, Key>::emplace(std::forward<TArgs>(args)...);
+        }
+    };
+
+    // ===================================================================
+    // sample types
+
+    // invariant: m_max == m_min + 100 and m_version == m_min - a torn value violates it
+    struct Limits
+    {
+        std::int64_t  m_min{};
+        std::int64_t  m_max{ 100 };
+        double        m_scale{ 1.0 };
+        std::uint64_t m_version{};
+
+        bool isConsistent() const {
+            return m_max == m_min + 100 && m_version == static_cast<std::uint64_t>(m_min);
+        }
+    };
+
+    class Person
+    {
+    private:
+        std::string m_name;
+        int m_age;
+
+    public:
+        Person() : m_name{}, m_age{} {}
+
+        Person(const std::string& name, const int age)
+            : m_name{ name }, m_age{ age }
+        {}
+
+        std::string operator()() const {
+            return m_name + " [" + std::to_string(m_age) + "]";
+        }
+    };
+
+    static void test_01()
+    {
+        struct Key1;
+        struct Key2;
+
+        using MyRepo = ConcurrentRepository<
+            ConcurrentSlot<int>,
+            ConcurrentSlot<Limits>,
+            ConcurrentSlot<std::string, Key1>,
+            ConcurrentSlot<std::string, Key2>,
+            ConcurrentSlot<Person>
+        >;
+
+        MyRepo repo{};
+
+        repo.set(12345); // note type deduction: we pass an int, so it writes to the int slot
+        repo.set<std::string, Key1>("ABC");
+        repo.emplace<std::string, Key2>(5, '*');
+        repo.emplace<Limits>(7, 107, 0.5, 7u);
+        repo.emplace<Person>(std::string{ "Hans" }, 21);
+
+        std::cout << repo.get<int>() << std::endl;                     // printing 12345
+        std::cout << repo.get<std::string, Key1>() << std::endl;       // printing "ABC"
+        std::cout << repo.get<std::string, Key2>() << std::endl;       // printing "*****"
+        std::cout << repo.get<Limits>().m_max << std::endl;            // printing 107
+        std::cout << repo.get<Person>()() << std::endl;                // printing "Hans [21]"
+
+        // no copy of the string
+        std::size_t length{ repo.read<std::string, Key1>([](const std::string& s) { return s.size(); }) };
+        std::cout << length << std::endl;                              // printing 3
+
+        std::cout << "alignof(ConcurrentSlot<int>):  " << alignof(ConcurrentSlot<int>) << std::endl;
+        std::cout << "sizeof(MyRepo):                " << sizeof(MyRepo) << std::endl;
+    }
+
+    // ===================================================================
+    // benchmark: readers and one writer, contending for the same slots
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumReads = 1'000'000;      // debug, all readers together
+#else
+    static constexpr std::size_t NumReads = 20'000'000;     // release, all readers together
+#endif
+
+    static constexpr std::array<std::size_t, 4> NumReaders{ 1, 2, 4, 8 };
+
+    static constexpr std::string_view Text{ "A value longer than the small string buffer" };
+
+    template <typename TRepository>
+    static void runContention(std::string_view label, std::size_t numReaders)
+    {
+        TRepository repo{};
+        repo.template emplace<std::string>(Text);
+
+        std::atomic<bool> done{ false };
+        std::atomic<std::size_t> inconsistent{};
+        std::size_t writes{};
+
+        const auto start{ std::chrono::steady_clock::now() };
+        {
+            std::jthread writer{ [&] {
+                for (std::int64_t i{ 1 }; !done.load(std::memory_order_relaxed); ++i) {
+                    repo.template emplace<Limits>(i, i + 100, 0.5 * static_cast<double>(i), static_cast<std::uint64_t>(i));
+                    repo.template emplace<std::string>(Text.substr(0, static_cast<std::size_t>(i) % Text.size()));
+                    ++writes;
+                }
+            } };
+
+            {
+                std::vector<std::jthread> readers{};
+                for (std::size_t t{}; t != numReaders; ++t) {
+                    readers.emplace_back([&] {
+                        std::size_t errors{};
+
+                        for (std::size_t i{}; i != NumReads / numReaders; ++i) {
+                            const Limits limits{ repo.template get<Limits>() };
+                            errors += limits.isConsistent() ? 0 : 1;
+
+                            // the string is always a prefix of Text
+                            errors += repo.template read<std::string>([](const std::string& s) {
+                                return Text.starts_with(s) ? 0 : 1;
+                            });
+                        }
+
+                        inconsistent += errors;
+                    });
+                }
+            }
+
+            done = true;
+        }
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double> seconds{ end - start };
+        std::println("  {:<28}{:8.1f} million reads/s - writes: {:>9} - inconsistent: {}",
+            label, NumReads / seconds.count() / 1e6, writes, inconsistent.load());
+    }
+
+    static void test_02()
+    {
+        using LockedRepository = ConcurrentRepository<LockedSlot<Limits>, LockedSlot<std::string>>;
+        using LockFreeRepository = ConcurrentRepository<ConcurrentSlot<Limits>, ConcurrentSlot<std::string>>;
+
+        for (auto numReaders : NumReaders) {
+            std::println("{} reader(s) + 1 writer:", numReaders);
+            runContention<LockedRepository>("std::mutex:", numReaders);
+            runContention<LockFreeRepository>("Seqlock + double buffer:", numReaders);
+        }
+    }
+}
+
+void main_variadic_templates_concurrent_mixins()
+{
+    using namespace VariadicTemplatesConcurrentMixins;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -5,6 +5,7 @@
 export module modern_cpp:variant;
 
 export void main_variant();
+export void main_variant_fast_visit();
 
 // =====================================================================================
 // End-of-File
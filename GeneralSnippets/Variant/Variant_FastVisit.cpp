@@ -0,0 +1,419 @@
+// =====================================================================================
+// Variant_FastVisit.cpp // Visiting std::variant: switch and jump table
+// =====================================================================================
+
+module;
+
+#include <print>     // module implementation too unstable
+#include <variant>
+
+module modern_cpp:variant;
+
+import std;
+
+namespace VariantFastVisit {
+
+    // =================================================================================
+    // VariantFastVisit::visit - a replacement of std::visit for hot dispatch loops:
+    //
+    // - the alternatives of all visited variants are numbered consecutively
+    //   (row-major, as a multi-dimensional array): one flat index per combination
+    // - up to MaxSwitchCases combinations: a switch statement, which the compiler
+    //   turns into a compare chain or a jump table and can inline every case
+    // - more combinations: one constexpr table of function pointers, a single
+    //   indirect call for any number of visited variants
+    // - visitLikely<I...>: tests a dominant combination of alternatives first,
+    //   marked with [[likely]]
+    //
+    // As with std::visit, all invocations must have the same return type,
+    // a variant being valueless by exception throws std::bad_variant_access.
+    // =================================================================================
+
+    static constexpr std::size_t MaxSwitchCases{ 16 };
+
+    // access without checking the index - the caller has checked it
+    template <std::size_t I, typename TVariant>
+    constexpr decltype(auto) getUnchecked(TVariant&& variant) noexcept
+    {
+        if (variant.index() != I) {
+            std::unreachable();     // allows the compiler to drop the check in std::get_if
+        }
+
+        auto* alternative{ std::get_if<I>(std::addressof(variant)) };
+
+        if constexpr (std::is_lvalue_reference_v<TVariant>) {
+            return *alternative;
+        }
+        else {
+            return std::move(*alternative);
+        }
+    }
+
+    template <typename TVisitor, typename... TVariants>
+    using VisitResult = std::invoke_result_t<TVisitor, decltype(getUnchecked<0>(std::declval<TVariants>()))...>;
+
+    template <typename... TVariants>
+    static constexpr std::size_t NumCombinations{ (std::size_t{ 1 } * ... * std::variant_size_v<std::remove_cvref_t<TVariants>>) };
+
+    // flat index -> indices of the alternatives
+    template <typename... TVariants>
+    constexpr std::array<std::size_t, sizeof...(TVariants)> alternativeIndices(std::size_t flat)
+    {
+        constexpr std::array<std::size_t, sizeof...(TVariants)> sizes{ std::variant_size_v<std::remove_cvref_t<TVariants>>... };
+
+        std::array<std::size_t, sizeof...(TVariants)> indices{};
+
+        for (std::size_t k{ sizes.size() }; k-- > 0; ) {
+            indices[k] = flat % sizes[k];
+            flat /= sizes[k];
+        }
+
+        return indices;
+    }
+
+    // indices of the alternatives -> flat index
+    template <typename... TVariants>
+    constexpr std::size_t flatIndex(const TVariants&... variants)
+    {
+        std::size_t flat{};
+        ((flat = flat * std::variant_size_v<TVariants> + variants.index()), ...);
+        return flat;
+    }
+
+    template <typename... TVariants>
+    constexpr std::size_t flatIndexOf(const std::array<std::size_t, sizeof...(TVariants)>& indices)
+    {
+        constexpr std::array<std::size_t, sizeof...(TVariants)> sizes{ std::variant_size_v<std::remove_cvref_t<TVariants>>... };
+
+        std::size_t flat{};
+        for (std::size_t k{}; k != sizes.size(); ++k) {
+            flat = flat * sizes[k] + indices[k];
+        }
+        return flat;
+    }
+
+    // invokes the visitor for one combination of alternatives
+    template <std::size_t Flat, typename TResult, typename TVisitor, typename... TVariants>
+    constexpr TResult invokeCombination(TVisitor&& visitor, TVariants&&... variants)
+    {
+        constexpr auto indices{ alternativeIndices<TVariants...>(Flat) };
+
+        return[&]<std::size_t... Ks>(std::index_sequence<Ks...>) -> TResult {
+            return std::invoke(std::forward<TVisitor>(visitor), getUnchecked<indices[Ks]>(std::forward<TVariants>(variants))...);
+        }(std::index_sequence_for<TVariants...>{});
+    }
+
+    template <typename TResult, typename TVisitor, typename... TVariants>
+    constexpr TResult visitSwitch(std::size_t flat, TVisitor&& visitor, TVariants&&... variants)
+    {
+        constexpr std::size_t Count{ NumCombinations<TVariants...> };
+
+        auto combination = [&]<std::size_t Flat>() -> TResult {
+            if constexpr (Flat < Count) {
+                return invokeCombination<Flat, TResult>(std::forward<TVisitor>(visitor), std::forward<TVariants>(variants)...);
+            }
+            else {
+                std::unreachable();
+            }
+        };
+
+        static_assert(MaxSwitchCases == 16, "visitSwitch: adjust the number of cases");
+
+        switch (flat)
+        {
+        case 0: return combination.template operator()<0>();
+        case 1: return combination.template operator()<1>();
+        case 2: return combination.template operator()<2>();
+        case 3: return combination.template operator()<3>();
+        case 4: return combination.template operator()<4>();
+        case 5: return combination.template operator()<5>();
+        case 6: return combination.template operator()<6>();
+        case 7: return combination.template operator()<7>();
+        case 8: return combination.template operator()<8>();
+        case 9: return combination.template operator()<9>();
+        case 10: return combination.template operator()<10>();
+        case 11: return combination.template operator()<11>();
+        case 12: return combination.template operator()<12>();
+        case 13: return combination.template operator()<13>();
+        case 14: return combination.template operator()<14>();
+        case 15: return combination.template operator()<15>();
+        default: std::unreachable();
+        }
+    }
+
+    // one function per combination of alternatives
+    template <typename TResult, typename TVisitor, typename... TVariants>
+    static constexpr auto DispatchTable{
+        []<std::size_t... Flats>(std::index_sequence<Flats...>) {
+            using Function = TResult(*)(TVisitor&&, TVariants&&...);
+            return std::array<Function, sizeof...(Flats)>{ &invokeCombination<Flats, TResult, TVisitor, TVariants...>... };
+        }(std::make_index_sequence<NumCombinations<TVariants...>>{})
+    };
+
+    template <typename TResult, typename TVisitor, typename... TVariants>
+    constexpr TResult visitTable(std::size_t flat, TVisitor&& visitor, TVariants&&... variants)
+    {
+        return DispatchTable<TResult, TVisitor, TVariants...>[flat](std::forward<TVisitor>(visitor), std::forward<TVariants>(variants)...);
+    }
+
+    template <typename TVisitor, typename... TVariants>
+        requires (sizeof...(TVariants) > 0)
+    constexpr decltype(auto) visit(TVisitor&& visitor, TVariants&&... variants)
+    {
+        using Result = VisitResult<TVisitor, TVariants...>;
+
+        if ((variants.valueless_by_exception() || ...)) [[unlikely]] {
+            throw std::bad_variant_access{};
+        }
+
+        const std::size_t flat{ flatIndex(variants...) };
+
+        if constexpr (NumCombinations<TVariants...> <= MaxSwitchCases) {
+            return visitSwitch<Result>(flat, std::forward<TVisitor>(visitor), std::forward<TVariants>(variants)...);
+        }
+        else {
+            return visitTable<Result>(flat, std::forward<TVisitor>(visitor), std::forward<TVariants>(variants)...);
+        }
+    }
+
+    // one index per variant: the combination expected in most of the calls
+    template <std::size_t... Likely, typename TVisitor, typename... TVariants>
+        requires (sizeof...(Likely) == sizeof...(TVariants) && sizeof...(TVariants) > 0)
+    constexpr decltype(auto) visitLikely(TVisitor&& visitor, TVariants&&... variants)
+    {
+        static_assert(((Likely < std::variant_size_v<std::remove_cvref_t<TVariants>>) && ...), "visitLikely: index out of range");
+
+        using Result = VisitResult<TVisitor, TVariants...>;
+
+        if (((variants.index() == Likely) && ...)) [[likely]] {
+            constexpr std::size_t Flat{ flatIndexOf<TVariants...>({ Likely... }) };
+            return invokeCombination<Flat, Result>(std::forward<TVisitor>(visitor), std::forward<TVariants>(variants)...);
+        }
+
+        return VariantFastVisit::visit(std::forward<TVisitor>(visitor), std::forward<TVariants>(variants)...);
+    }
+
+    // =================================================================================
+    // Overload, as in Variant.cpp
+    // =================================================================================
+
+    template<class... Ts>
+    struct Overload : Ts... { using Ts::operator()...; };
+
+    template<class... Ts> Overload(Ts...) -> Overload<Ts...>;
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        std::variant<int, double, std::string> var{ "Hello" };
+
+        auto overloadSet = Overload{
+            [](const int& i) { std::println("const int&: {}", i); },
+            [](const double& f) { std::println("const double&: {}", f); },
+            [](const std::string& s) { std::println("const std::string&: {}", s); }
+        };
+
+        VariantFastVisit::visit(overloadSet, var);
+
+        var = 123;
+        VariantFastVisit::visit(overloadSet, var);
+
+        // modifying the alternative
+        VariantFastVisit::visit([](auto& value) { value += value; }, var);
+        VariantFastVisit::visit(overloadSet, var);
+
+        // rvalue variant: the alternative can be moved
+        std::variant<int, std::string> text{ std::string{ "moved" } };
+        std::string target{ VariantFastVisit::visit(Overload{
+            [](int i) { return std::to_string(i); },
+            [](std::string&& s) { return std::move(s); }
+            }, std::move(text)) };
+        std::println("Target: {}", target);
+
+        // two variants: 3 * 3 = 9 combinations - switch
+        std::variant<int, double, std::string> lhs{ 1 };
+        std::variant<int, double, std::string> rhs{ 2.5 };
+
+        auto describe = Overload{
+            [](const std::string&, const std::string&) { return std::string{ "string, string" }; },
+            [](const std::string&, const auto&) { return std::string{ "string, ..." }; },
+            [](const auto&, const std::string&) { return std::string{ "..., string" }; },
+            [](const auto& a, const auto& b) { return std::format("{} + {} = {}", a, b, a + b); }
+        };
+
+        std::println("{}", VariantFastVisit::visit(describe, lhs, rhs));
+        rhs = "Hello";
+        std::println("{}", VariantFastVisit::visit(describe, lhs, rhs));
+
+        // dominant alternative
+        std::println("{}", visitLikely<0, 1>(describe, lhs, std::variant<int, double, std::string>{ 3.5 }));
+
+        // three variants: 3 * 3 * 3 = 27 combinations - jump table,
+        // every combination is compared with std::visit
+        using Var = std::variant<int, double, std::string>;
+
+        static_assert(NumCombinations<Var, Var, Var> > MaxSwitchCases);
+
+        const std::array<Var, 3> values{ Var{ 1 }, Var{ 2.5 }, Var{ "three" } };
+
+        auto concat = [](const auto&... args) { return (std::format("{} ", args) + ...); };
+
+        std::size_t equal{};
+        for (const auto& first : values) {
+            for (const auto& second : values) {
+                for (const auto& third : values) {
+                    if (VariantFastVisit::visit(concat, first, second, third) == std::visit(concat, first, second, third)) {
+                        ++equal;
+                    }
+                }
+            }
+        }
+
+        std::println("Jump table: {} of 27 combinations equal to std::visit", equal);
+        std::println("{}", VariantFastVisit::visit(concat, values[2], values[0], values[1]));
+    }
+
+    // =================================================================================
+    // benchmark
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumElements = 1'000'000;        // debug
+#else
+    static constexpr std::size_t NumElements = 100'000'000;      // release
+#endif
+
+    // one variant: switch - two Small variants: switch (16 cases) - two Wide variants: jump table
+    using Small = std::variant<std::int32_t, std::uint32_t, float, std::int16_t>;
+
+    using Wide = std::variant<std::int8_t, std::uint8_t, std::int16_t, std::uint16_t, std::int32_t,
+        std::uint32_t, float, char, bool, char16_t>;
+
+    // probability of the first alternative in percent, the rest is distributed evenly
+    template <typename TVariant>
+    static std::vector<TVariant> createElements(std::size_t dominant)
+    {
+        constexpr std::size_t Alternatives{ std::variant_size_v<TVariant> };
+
+        std::vector<TVariant> elements{};
+        elements.reserve(NumElements);
+
+        std::mt19937 engine{ 42 };
+
+        for (std::size_t i{}; i != NumElements; ++i) {
+
+            const std::size_t value{ engine() };
+            const std::size_t index{ value % 100 < dominant ? 0 : 1 + (value >> 8) % (Alternatives - 1) };
+
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                static_cast<void>(((index == Is && (elements.emplace_back(std::in_place_index<Is>, static_cast<std::variant_alternative_t<Is, TVariant>>(value >> 16)), true)) || ...));
+            }(std::make_index_sequence<Alternatives>{});
+        }
+
+        return elements;
+    }
+
+    static constexpr auto Sum = Overload{
+        [](float value) { return static_cast<std::int64_t>(value * 2.0f); },
+        [](bool value) { return static_cast<std::int64_t>(value ? 3 : 5); },
+        [](auto value) { return static_cast<std::int64_t>(value); }
+    };
+
+    static constexpr auto SumOfTwo = Overload{
+        [](float lhs, float rhs) { return static_cast<std::int64_t>(lhs * rhs); },
+        [](auto lhs, auto rhs) { return static_cast<std::int64_t>(lhs) - static_cast<std::int64_t>(rhs); }
+    };
+
+    template <typename TLoop>
+    static void measure(std::string_view label, TLoop loop)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+        const std::int64_t result{ loop() };
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double, std::milli> elapsed{ end - start };
+        std::println("  {:<36}{:9.1f} ms  (result {})", label, elapsed.count(), result);
+    }
+
+    template <typename TVariant>
+    static void compareSingle(std::string_view title, std::size_t dominant)
+    {
+        const auto elements{ createElements<TVariant>(dominant) };
+
+        std::println("{} - {} alternatives, first alternative {}%:", title, std::variant_size_v<TVariant>, dominant);
+
+        measure("std::visit:", [&] {
+            std::int64_t sum{};
+            for (const auto& element : elements) {
+                sum += std::visit(Sum, element);
+            }
+            return sum;
+        });
+
+        measure("VariantFastVisit::visit:", [&] {
+            std::int64_t sum{};
+            for (const auto& element : elements) {
+                sum += VariantFastVisit::visit(Sum, element);
+            }
+            return sum;
+        });
+
+        measure("VariantFastVisit::visitLikely<0>:", [&] {
+            std::int64_t sum{};
+            for (const auto& element : elements) {
+                sum += visitLikely<0>(Sum, element);
+            }
+            return sum;
+        });
+    }
+
+    template <typename TVariant>
+    static void comparePairs(std::string_view title)
+    {
+        const auto elements{ createElements<TVariant>(0) };
+
+        std::println("{} - two variants, {} combinations:", title, NumCombinations<TVariant, TVariant>);
+
+        measure("std::visit:", [&] {
+            std::int64_t sum{};
+            for (std::size_t i{ 1 }; i < elements.size(); ++i) {
+                sum += std::visit(SumOfTwo, elements[i - 1], elements[i]);
+            }
+            return sum;
+        });
+
+        measure("VariantFastVisit::visit:", [&] {
+            std::int64_t sum{};
+            for (std::size_t i{ 1 }; i < elements.size(); ++i) {
+                sum += VariantFastVisit::visit(SumOfTwo, elements[i - 1], elements[i]);
+            }
+            return sum;
+        });
+    }
+
+    static void test_02()
+    {
+        std::println("{} elements:", NumElements);
+
+        compareSingle<Small>("Small", 25);
+        compareSingle<Small>("Small", 95);
+        compareSingle<Wide>("Wide", 10);
+        compareSingle<Wide>("Wide", 95);
+        comparePairs<Small>("Small");
+        comparePairs<Wide>("Wide");
+    }
+}
+
+void main_variant_fast_visit()
+{
+    using namespace VariantFastVisit;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
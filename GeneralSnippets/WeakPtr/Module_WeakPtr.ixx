@@ -5,6 +5,8 @@
 export module modern_cpp:weak_ptr;
 
 export void main_weak_pointer();
+export void main_weak_pointer_epoch_reclamation();
+export void main_weak_pointer_slab_tree();
 
 // =====================================================================================
 // End-of-File
@@ -0,0 +1,441 @@
+// =====================================================================================
+// WeakPtr_EpochReclamation.cpp // Epoch-based reclamation: deferred deletion without weak_ptr
+// =====================================================================================
+
+module modern_cpp:weak_ptr;
+
+import std;
+
+namespace WeakPointerEpochReclamation {
+
+    // =================================================================================
+    // EpochDomain
+    //
+    // Readers never modify a shared counter (compare with std::weak_ptr::lock()):
+    //
+    // - every reader thread owns a slot (cache line) of the domain
+    // - entering a critical section stores the current global epoch into this slot,
+    //   leaving it stores 0 - both stores go to the reader's own cache line
+    // - a writer unpublishes an object and hands it over with retire(ptr, deleter),
+    //   the object is tagged with the global epoch at this moment
+    // - the global epoch can be advanced, if all active readers have seen
+    //   the current epoch. An object retired in epoch e is deleted,
+    //   as soon as the global epoch has reached e + 2: then no reader
+    //   can hold a reference to it any more.
+    //
+    // Reclamation is amortized: every RetireThreshold retirements
+    // the writer tries to advance the epoch and deletes what has become safe.
+    // =================================================================================
+
+    class EpochDomain
+    {
+    public:
+        static constexpr std::size_t MaxReaders{ 128 };
+        static constexpr std::size_t RetireThreshold{ 64 };
+
+    private:
+        static constexpr std::size_t CacheLineSize{ 64 };
+
+        struct alignas(CacheLineSize) Slot
+        {
+            std::atomic<std::uint64_t> m_epoch{ 0 };   // 0: not inside a critical section
+            std::atomic<bool>          m_used{ false };
+        };
+
+        struct Retired
+        {
+            std::function<void()> m_deleter;
+            std::uint64_t         m_epoch;
+        };
+
+        std::array<Slot, MaxReaders> m_slots;
+        alignas(CacheLineSize) std::atomic<std::uint64_t> m_epoch;
+
+        std::mutex           m_mutex;       // writer side only
+        std::vector<Retired> m_retired;
+        std::size_t          m_sinceLastScan;
+
+    public:
+        EpochDomain() : m_slots{}, m_epoch{ 1 }, m_sinceLastScan{} {}
+
+        // no readers may be active any more: everything left is deleted
+        ~EpochDomain() {
+            for (auto& retired : m_retired) {
+                retired.m_deleter();
+            }
+        }
+
+        // no copying or moving
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        EpochDomain(EpochDomain&&) noexcept = delete;
+        EpochDomain& operator=(EpochDomain&&) noexcept = delete;
+
+        // =============================================================================
+        // reader side
+        // =============================================================================
+
+        class Guard;
+
+        // registration of a reader thread: claims one slot of the domain
+        class Reader
+        {
+        private:
+            EpochDomain& m_domain;
+            Slot*        m_slot;
+
+            friend class Guard;
+
+        public:
+            explicit Reader(EpochDomain& domain) : m_domain{ domain }, m_slot{ domain.acquireSlot() } {}
+
+            ~Reader() {
+                m_slot->m_epoch.store(0, std::memory_order_release);
+                m_slot->m_used.store(false, std::memory_order_release);
+            }
+
+            // no copying or moving
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            Reader(Reader&&) noexcept = delete;
+            Reader& operator=(Reader&&) noexcept = delete;
+
+            Guard pin() { return Guard{ *this }; }
+        };
+
+        // RAII critical section - objects loaded inside stay valid until it ends
+        class Guard
+        {
+        private:
+            Slot* m_slot;
+
+        public:
+            explicit Guard(Reader& reader) : m_slot{ reader.m_slot }
+            {
+                const std::uint64_t epoch{ reader.m_domain.m_epoch.load(std::memory_order_relaxed) };
+                m_slot->m_epoch.store(epoch, std::memory_order_relaxed);
+
+                // the announcement must be visible before the shared pointer is read:
+                // no read-modify-write, no foreign cache line - but a full fence
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+
+            ~Guard() {
+                m_slot->m_epoch.store(0, std::memory_order_release);
+            }
+
+            // no copying or moving
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+            Guard(Guard&&) noexcept = delete;
+            Guard& operator=(Guard&&) noexcept = delete;
+        };
+
+        // =============================================================================
+        // writer side
+        // =============================================================================
+
+        template <typename T, typename TDeleter = std::default_delete<T>>
+        void retire(T* ptr, TDeleter deleter = TDeleter{})
+        {
+            if (ptr == nullptr) {
+                return;
+            }
+
+            std::vector<Retired> reclaimable{};
+            {
+                std::lock_guard guard{ m_mutex };
+
+                m_retired.push_back(
+                    Retired{
+                        [ptr, deleter = std::move(deleter)]() mutable { deleter(ptr); },
+                        m_epoch.load(std::memory_order_relaxed)
+                    }
+                );
+
+                if (++m_sinceLastScan >= RetireThreshold) {
+                    m_sinceLastScan = 0;
+                    tryAdvance();
+                    reclaimable = collect();
+                }
+            }
+
+            // deleters run outside of the lock
+            for (auto& retired : reclaimable) {
+                retired.m_deleter();
+            }
+        }
+
+        // deletes everything that is already safe, independent of RetireThreshold
+        void reclaim()
+        {
+            std::vector<Retired> reclaimable{};
+            {
+                std::lock_guard guard{ m_mutex };
+                tryAdvance();
+                reclaimable = collect();
+            }
+
+            for (auto& retired : reclaimable) {
+                retired.m_deleter();
+            }
+        }
+
+        std::size_t pending() {
+            std::lock_guard guard{ m_mutex };
+            return m_retired.size();
+        }
+
+    private:
+        Slot* acquireSlot()
+        {
+            for (auto& slot : m_slots) {
+                bool expected{ false };
+                if (!slot.m_used.load(std::memory_order_relaxed) &&
+                    slot.m_used.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                {
+                    return &slot;
+                }
+            }
+
+            throw std::runtime_error{ "EpochDomain: too many reader threads" };
+        }
+
+        // m_mutex is held
+        void tryAdvance()
+        {
+            // pairs with the fence of the readers: either a reader's announcement
+            // is seen here, or the reader sees the unpublished pointer
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            const std::uint64_t epoch{ m_epoch.load(std::memory_order_relaxed) };
+
+            for (const auto& slot : m_slots) {
+                const std::uint64_t announced{ slot.m_epoch.load(std::memory_order_acquire) };
+                if (announced != 0 && announced != epoch) {
+                    return;   // a reader is still inside an older epoch
+                }
+            }
+
+            m_epoch.store(epoch + 1, std::memory_order_release);
+        }
+
+        // m_mutex is held
+        std::vector<Retired> collect()
+        {
+            const std::uint64_t epoch{ m_epoch.load(std::memory_order_relaxed) };
+
+            auto safe = [=](const Retired& retired) { return retired.m_epoch + 2 <= epoch; };
+
+            auto pos{ std::partition(m_retired.begin(), m_retired.end(), std::not_fn(safe)) };
+
+            std::vector<Retired> reclaimable{ std::make_move_iterator(pos), std::make_move_iterator(m_retired.end()) };
+            m_retired.erase(pos, m_retired.end());
+            return reclaimable;
+        }
+    };
+
+    // =================================================================================
+    // Watchers (compare with UnsafeWatcher and LightweightAndSafeWatcher
+    // in Exercises_15_SmartPointers.cpp)
+    // =================================================================================
+
+    // the watched value can be replaced at any time, readers never see freed memory
+    class EpochWatcher
+    {
+    private:
+        EpochDomain&            m_domain;
+        std::atomic<const int*> m_ptr;
+
+    public:
+        explicit EpochWatcher(EpochDomain& domain) : m_domain{ domain }, m_ptr{ nullptr } {}
+
+        ~EpochWatcher() {
+            m_domain.retire(m_ptr.load());
+        }
+
+        // no copying or moving
+        EpochWatcher(const EpochWatcher&) = delete;
+        EpochWatcher& operator=(const EpochWatcher&) = delete;
+
+        EpochWatcher(EpochWatcher&&) noexcept = delete;
+        EpochWatcher& operator=(EpochWatcher&&) noexcept = delete;
+
+        void watch(int value)
+        {
+            const int* old{ m_ptr.exchange(new int{ value }, std::memory_order_seq_cst) };
+            m_domain.retire(old);
+        }
+
+        void unwatch()
+        {
+            m_domain.retire(m_ptr.exchange(nullptr, std::memory_order_seq_cst));
+        }
+
+        std::optional<int> currentValue(EpochDomain::Reader& reader) const
+        {
+            auto guard{ reader.pin() };
+
+            const int* ptr{ m_ptr.load(std::memory_order_acquire) };
+            if (ptr == nullptr) {
+                return std::nullopt;
+            }
+
+            return *ptr;    // *ptr can't be freed before the guard is left
+        }
+    };
+
+    // the std::weak_ptr solution: one atomic read-modify-write per read
+    class WeakPtrWatcher
+    {
+    private:
+        std::weak_ptr<int> m_ptr;
+
+    public:
+        void watch(const std::shared_ptr<int>& sp)
+        {
+            m_ptr = sp;
+        }
+
+        std::optional<int> currentValue() const
+        {
+            std::shared_ptr<int> sp{ m_ptr.lock() };
+            if (sp == nullptr) {
+                return std::nullopt;
+            }
+
+            return *sp;
+        }
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        EpochDomain domain{};
+        EpochDomain::Reader reader{ domain };
+
+        EpochWatcher watcher{ domain };
+
+        watcher.watch(123);
+        std::println("Value: {}", watcher.currentValue(reader).value_or(-1));
+
+        {
+            // the value is replaced inside of a critical section:
+            // the old one is retired, but can't be deleted yet
+            auto guard{ reader.pin() };
+
+            watcher.watch(456);
+            domain.reclaim();
+            domain.reclaim();
+            std::println("Pending (reader inside critical section): {}", domain.pending());
+        }
+
+        domain.reclaim();
+        domain.reclaim();
+        std::println("Pending (reader has left):                {}", domain.pending());
+
+        std::println("Value: {}", watcher.currentValue(reader).value_or(-1));
+
+        watcher.unwatch();
+        std::println("Value: {}", watcher.currentValue(reader).value_or(-1));
+    }
+
+    // =================================================================================
+    // benchmark: read-side throughput
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t NumReads = 2'000'000;      // debug, all readers together
+#else
+    static constexpr std::size_t NumReads = 8'000'000;      // release, all readers together
+#endif
+
+    static constexpr std::array<std::size_t, 7> NumThreads{ 1, 2, 4, 8, 16, 32, 64 };
+
+    template <typename TRead>
+    static void runReaders(std::string_view label, std::size_t numThreads, TRead read)
+    {
+        std::atomic<std::size_t> sum{};
+
+        std::println("{} - {} thread(s):", label, numThreads);
+
+        const auto start{ std::chrono::steady_clock::now() };
+        {
+            std::vector<std::jthread> readers;
+            for (std::size_t t{}; t != numThreads; ++t) {
+                readers.emplace_back([&] {
+                    sum += read(NumReads / numThreads);
+                });
+            }
+        }
+        const auto end{ std::chrono::steady_clock::now() };
+
+        const std::chrono::duration<double> seconds{ end - start };
+        std::println("{:.1f} million reads/s (sum {})", NumReads / seconds.count() / 1e6, sum.load());
+    }
+
+    static void test_02()
+    {
+        for (auto numThreads : NumThreads) {
+
+            {
+                std::shared_ptr<int> sp{ std::make_shared<int>(1) };
+                WeakPtrWatcher watcher{};
+                watcher.watch(sp);
+
+                runReaders("std::weak_ptr::lock()", numThreads, [&](std::size_t count) {
+                    std::size_t sum{};
+                    for (std::size_t i{}; i != count; ++i) {
+                        sum += watcher.currentValue().value_or(0);
+                    }
+                    return sum;
+                });
+            }
+
+            {
+                EpochDomain domain{};
+                EpochWatcher watcher{ domain };
+                watcher.watch(1);
+
+                // additionally a writer replaces the value every 100 microseconds
+                std::atomic<bool> done{ false };
+                std::jthread writer{ [&] {
+                    while (!done.load()) {
+                        watcher.watch(1);
+                        std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+                    }
+                } };
+
+                runReaders("EpochDomain + writer", numThreads, [&](std::size_t count) {
+                    EpochDomain::Reader reader{ domain };
+                    std::size_t sum{};
+                    for (std::size_t i{}; i != count; ++i) {
+                        sum += watcher.currentValue(reader).value_or(0);
+                    }
+                    return sum;
+                });
+
+                done = true;
+            }
+
+            std::println();
+        }
+    }
+}
+
+void main_weak_pointer_epoch_reclamation()
+{
+    using namespace WeakPointerEpochReclamation;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -0,0 +1,453 @@
+// =====================================================================================
+// WeakPtr_SlabTree.cpp // Trees without std::shared_ptr / std::weak_ptr: nodes in slabs
+// =====================================================================================
+
+module modern_cpp:weak_ptr;
+
+import std;
+import scoped_timer;
+
+namespace WeakPointerSlabTree {
+
+    // =================================================================================
+    // SlabTree<T>
+    //
+    // In WeakPtr.cpp every node is a separate allocation with its own control block,
+    // children are owned by std::shared_ptr, parents are referenced by std::weak_ptr.
+    //
+    // Here, the tree owns all nodes:
+    // - nodes are allocated from slabs of SlabSize nodes (node addresses are stable),
+    // - links are 32-bit indices (first child, next sibling, parent),
+    // - no reference counts: a parent back reference can't form a cycle,
+    // - clear() releases whole slabs - for trivially destructible T
+    //   this costs O(number of slabs), not O(number of nodes).
+    // =================================================================================
+
+    enum class TraversalOrder { DepthFirst, BreadthFirst };
+
+    template <typename T>
+    class SlabTree
+    {
+    public:
+        using NodeId = std::uint32_t;
+
+        static constexpr NodeId NullNode{ std::numeric_limits<NodeId>::max() };
+
+    private:
+        static constexpr std::size_t SlabBits{ 12 };
+        static constexpr std::size_t SlabSize{ std::size_t{ 1 } << SlabBits };   // 4096 nodes
+        static constexpr std::size_t SlabMask{ SlabSize - 1 };
+
+        struct Node
+        {
+            T      m_value;
+            NodeId m_parent;
+            NodeId m_firstChild;
+            NodeId m_lastChild;      // appending a child is O(1)
+            NodeId m_nextSibling;
+        };
+
+        std::vector<Node*> m_slabs;
+        std::size_t        m_size;
+
+    public:
+        SlabTree() : m_slabs{}, m_size{} {}
+
+        ~SlabTree() {
+            clear();
+        }
+
+        SlabTree(const SlabTree&) = delete;
+        SlabTree& operator=(const SlabTree&) = delete;
+
+        SlabTree(SlabTree&& other) noexcept
+            : m_slabs{ std::move(other.m_slabs) }, m_size{ std::exchange(other.m_size, 0) }
+        {
+            other.m_slabs.clear();
+        }
+
+        SlabTree& operator=(SlabTree&& other) noexcept
+        {
+            if (this != &other) {
+                clear();
+                m_slabs = std::move(other.m_slabs);
+                m_size = std::exchange(other.m_size, 0);
+                other.m_slabs.clear();
+            }
+            return *this;
+        }
+
+        // getter
+        std::size_t size() const noexcept { return m_size; }
+        bool empty() const noexcept { return m_size == 0; }
+        std::size_t slabs() const noexcept { return m_slabs.size(); }
+
+        NodeId root() const noexcept { return m_size == 0 ? NullNode : 0; }
+
+        T& operator[] (NodeId id) noexcept { return node(id).m_value; }
+        const T& operator[] (NodeId id) const noexcept { return node(id).m_value; }
+
+        NodeId parent(NodeId id) const noexcept { return node(id).m_parent; }
+        NodeId firstChild(NodeId id) const noexcept { return node(id).m_firstChild; }
+        NodeId nextSibling(NodeId id) const noexcept { return node(id).m_nextSibling; }
+
+        // creates the root (parent == NullNode) or appends a child to parent
+        template <typename... TArgs>
+        NodeId emplace(NodeId parent, TArgs&&... args)
+        {
+            if (parent == NullNode && m_size != 0) {
+                throw std::logic_error{ "SlabTree: root already exists" };
+            }
+
+            if (m_size == NullNode) {
+                throw std::length_error{ "SlabTree: too many nodes" };
+            }
+
+            if ((m_size & SlabMask) == 0 && (m_size >> SlabBits) == m_slabs.size()) {
+                Node* slab{ std::allocator<Node>{}.allocate(SlabSize) };
+
+                try {
+                    m_slabs.push_back(slab);
+                }
+                catch (...) {
+                    std::allocator<Node>{}.deallocate(slab, SlabSize);   // no leak if push_back throws
+                    throw;
+                }
+            }
+
+            const NodeId id{ static_cast<NodeId>(m_size) };
+            std::construct_at(
+                &m_slabs[id >> SlabBits][id & SlabMask],
+                Node{ T{ std::forward<TArgs>(args)... }, parent, NullNode, NullNode, NullNode }
+            );
+            ++m_size;
+
+            if (parent != NullNode) {
+                Node& parentNode{ node(parent) };
+                if (parentNode.m_lastChild == NullNode) {
+                    parentNode.m_firstChild = id;
+                }
+                else {
+                    node(parentNode.m_lastChild).m_nextSibling = id;
+                }
+                parentNode.m_lastChild = id;
+            }
+
+            return id;
+        }
+
+        void clear() noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (std::size_t i{}; i != m_size; ++i) {
+                    std::destroy_at(&m_slabs[i >> SlabBits][i & SlabMask]);
+                }
+            }
+
+            for (Node* slab : m_slabs) {
+                std::allocator<Node>{}.deallocate(slab, SlabSize);
+            }
+
+            m_slabs.clear();
+            m_size = 0;
+        }
+
+        // =============================================================================
+        // traversals
+        // =============================================================================
+
+        // all nodes in storage order - the fastest way, if the order doesn't matter
+        template <typename TFunc>
+        void forEach(TFunc func) const
+        {
+            std::size_t remaining{ m_size };
+            for (const Node* slab : m_slabs) {
+                const std::size_t count{ std::min(remaining, SlabSize) };
+                for (std::size_t i{}; i != count; ++i) {
+                    func(slab[i].m_value);
+                }
+                remaining -= count;
+            }
+        }
+
+        // pre-order, func(NodeId, depth) - neither recursion nor a stack is needed,
+        // the way back up uses the parent links
+        template <typename TFunc>
+        void depthFirst(TFunc func) const
+        {
+            NodeId id{ root() };
+            std::size_t depth{};
+
+            while (id != NullNode) {
+                func(id, depth);
+
+                if (const NodeId child{ firstChild(id) }; child != NullNode) {
+                    id = child;
+                    ++depth;
+                    continue;
+                }
+
+                while (id != NullNode && nextSibling(id) == NullNode) {
+                    id = parent(id);
+                    --depth;
+                }
+
+                if (id != NullNode) {
+                    id = nextSibling(id);
+                }
+            }
+        }
+
+        // level by level, func(NodeId, depth)
+        template <typename TFunc>
+        void breadthFirst(TFunc func) const
+        {
+            if (m_size == 0) {
+                return;
+            }
+
+            std::vector<std::pair<NodeId, std::size_t>> queue{};
+            queue.reserve(m_size);
+            queue.emplace_back(root(), 0);
+
+            for (std::size_t head{}; head != queue.size(); ++head) {
+                const auto [id, depth] { queue[head] };
+
+                func(id, depth);
+
+                for (NodeId child{ firstChild(id) }; child != NullNode; child = nextSibling(child)) {
+                    queue.emplace_back(child, depth + 1);
+                }
+            }
+        }
+
+        // copy of the tree with the nodes stored in the given traversal order:
+        // afterwards, this traversal walks through memory sequentially
+        SlabTree relayout(TraversalOrder order) const
+        {
+            std::vector<NodeId> sequence{};
+            sequence.reserve(m_size);
+
+            auto collect = [&](NodeId id, std::size_t) { sequence.push_back(id); };
+
+            if (order == TraversalOrder::DepthFirst) {
+                depthFirst(collect);
+            }
+            else {
+                breadthFirst(collect);
+            }
+
+            // parents are always visited before their children
+            std::vector<NodeId> newIds(m_size, NullNode);
+
+            SlabTree result{};
+            for (NodeId id : sequence) {
+                const NodeId oldParent{ parent(id) };
+                const NodeId newParent{ oldParent == NullNode ? NullNode : newIds[oldParent] };
+                newIds[id] = result.emplace(newParent, (*this)[id]);
+            }
+
+            return result;
+        }
+
+    private:
+        Node& node(NodeId id) noexcept { return m_slabs[id >> SlabBits][id & SlabMask]; }
+        const Node& node(NodeId id) const noexcept { return m_slabs[id >> SlabBits][id & SlabMask]; }
+    };
+
+    // =================================================================================
+    // the same tree with std::shared_ptr / std::weak_ptr (as in WeakPtr.cpp)
+    // =================================================================================
+
+    struct SharedNode
+    {
+        int                         m_value;
+        std::shared_ptr<SharedNode> m_left;
+        std::shared_ptr<SharedNode> m_right;
+        std::weak_ptr<SharedNode>   m_parent;
+
+        explicit SharedNode(int value) : m_value{ value } {}
+    };
+
+    // =================================================================================
+    // testing
+    // =================================================================================
+
+    static void test_01()
+    {
+        SlabTree<std::string> tree{};
+
+        auto parent{ tree.emplace(SlabTree<std::string>::NullNode, "ParentNode") };
+        auto left{ tree.emplace(parent, "LeftNode") };
+        auto right{ tree.emplace(parent, "RightNode") };
+        tree.emplace(left, "LeftNode of LeftNode");
+        tree.emplace(right, "LeftNode of RightNode");
+        tree.emplace(right, "RightNode of RightNode");
+
+        // no cycles, no reference counts: the parent is just an index
+        std::println("Parent of {}: {}", tree[left], tree[tree.parent(left)]);
+
+        std::println("Depth-first:");
+        tree.depthFirst([&](auto id, std::size_t depth) {
+            std::println("{:{}}{}", "", 2 * depth, tree[id]);
+        });
+
+        std::println("Breadth-first:");
+        tree.breadthFirst([&](auto id, std::size_t depth) {
+            std::println("{:{}}{}", "", 2 * depth, tree[id]);
+        });
+
+        // order doesn't matter: storage order
+        std::size_t characters{};
+        tree.forEach([&](const std::string& name) { characters += name.size(); });
+        std::println("Characters: {}", characters);
+    }
+
+    // =================================================================================
+    // benchmark: complete binary tree, built depth-first
+    // =================================================================================
+
+#ifdef _DEBUG
+    static constexpr std::size_t TreeDepth = 16;    // debug:   65.535 nodes
+#else
+    static constexpr std::size_t TreeDepth = 21;    // release: 2.097.151 nodes
+#endif
+
+    static std::shared_ptr<SharedNode> buildShared(const std::shared_ptr<SharedNode>& parent, std::size_t depth, int& counter)
+    {
+        auto node{ std::make_shared<SharedNode>(counter++) };
+        node->m_parent = parent;
+
+        if (depth > 1) {
+            node->m_left = buildShared(node, depth - 1, counter);
+            node->m_right = buildShared(node, depth - 1, counter);
+        }
+
+        return node;
+    }
+
+    // sum of all values plus the value of their parent (using std::weak_ptr::lock())
+    static std::size_t traverseShared(const std::shared_ptr<SharedNode>& node)
+    {
+        if (!node) {
+            return 0;
+        }
+
+        std::size_t sum{ static_cast<std::size_t>(node->m_value) };
+        if (auto parent{ node->m_parent.lock() }) {
+            sum += static_cast<std::size_t>(parent->m_value);
+        }
+
+        return sum + traverseShared(node->m_left) + traverseShared(node->m_right);
+    }
+
+    static void buildSlab(SlabTree<int>& tree, SlabTree<int>::NodeId parent, std::size_t depth, int& counter)
+    {
+        auto id{ tree.emplace(parent, counter++) };
+
+        if (depth > 1) {
+            buildSlab(tree, id, depth - 1, counter);
+            buildSlab(tree, id, depth - 1, counter);
+        }
+    }
+
+    static std::size_t traverseSlab(const SlabTree<int>& tree)
+    {
+        std::size_t sum{};
+
+        tree.depthFirst([&](auto id, std::size_t) {
+            sum += static_cast<std::size_t>(tree[id]);
+            if (auto parent{ tree.parent(id) }; parent != SlabTree<int>::NullNode) {
+                sum += static_cast<std::size_t>(tree[parent]);
+            }
+        });
+
+        return sum;
+    }
+
+    static void test_02()
+    {
+        std::println("std::shared_ptr / std::weak_ptr:");
+        {
+            std::shared_ptr<SharedNode> root{};
+            int counter{};
+
+            std::print("  Build:    ");
+            {
+                ScopedTimer watch{};
+                root = buildShared(nullptr, TreeDepth, counter);
+            }
+
+            std::size_t sum{};
+            std::print("  Traverse: ");
+            {
+                ScopedTimer watch{};
+                sum = traverseShared(root);
+            }
+
+            std::print("  Destroy:  ");
+            {
+                ScopedTimer watch{};
+                root.reset();
+            }
+            std::println("  Nodes: {}, Sum: {}", counter, sum);
+        }
+
+        std::println("SlabTree:");
+        {
+            SlabTree<int> tree{};
+            int counter{};
+
+            std::print("  Build:    ");
+            {
+                ScopedTimer watch{};
+                buildSlab(tree, SlabTree<int>::NullNode, TreeDepth, counter);
+            }
+
+            std::size_t sum{};
+            std::print("  Traverse: ");
+            {
+                ScopedTimer watch{};
+                sum = traverseSlab(tree);
+            }
+
+            std::size_t sumBreadthFirst{};
+            std::print("  Traverse (breadth-first): ");
+            {
+                ScopedTimer watch{};
+                tree.breadthFirst([&](auto id, std::size_t) {
+                    sumBreadthFirst += static_cast<std::size_t>(tree[id]);
+                });
+            }
+
+            auto relaid{ tree.relayout(TraversalOrder::BreadthFirst) };
+            std::size_t sumRelaid{};
+            std::print("  Traverse (breadth-first, relayout): ");
+            {
+                ScopedTimer watch{};
+                relaid.breadthFirst([&](auto id, std::size_t) {
+                    sumRelaid += static_cast<std::size_t>(relaid[id]);
+                });
+            }
+
+            const std::size_t slabs{ tree.slabs() };
+            std::print("  Destroy:  ");
+            {
+                ScopedTimer watch{};
+                tree.clear();
+            }
+            std::println("  Nodes: {}, Slabs: {}, Sum: {} ({} / {})", counter, slabs, sum, sumBreadthFirst, sumRelaid);
+        }
+    }
+}
+
+void main_weak_pointer_slab_tree()
+{
+    using namespace WeakPointerSlabTree;
+    test_01();
+    test_02();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================